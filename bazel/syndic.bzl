@@ -9,6 +9,9 @@ def syndic(
         headersname="headers",
         modulename="module",
 
+        # defines that change the headers, and so also apply to dependents
+        headers_defines=[],
+
         headers_deps=[],
         code_deps=[],
 
@@ -29,6 +32,7 @@ def syndic(
 
         includes = includes,
         hdrs = hdrs,
+        defines = headers_defines,
 
         linkopts = headers_linkopts,
     )
@@ -0,0 +1,196 @@
+#include "syn/common.h"
+#include "syn/syn.h"
+
+#include "bench/harness.h"
+
+using namespace syn;
+using namespace syn_bench;
+
+/******************************************************************************
+** is_a
+******************************************************************************/
+
+namespace
+{
+	// A chain of abstract types `chain[i] is-a chain[i - 1]`, built once in the thread store.
+	std::vector<TypeId> const& abstract_chain()
+	{
+		static std::vector<TypeId> chain = []()
+		{
+			auto& store = thread_store();
+
+			std::vector<TypeId> res;
+			Graph::Node* prev = nullptr;
+			for (size_t i = 0; i <= 64; ++i)
+			{
+				auto n = store.addNode<core::NAbstract>({ });
+				if (prev != nullptr)
+					store.addIsA(n, prev);
+				res.push_back(n);
+				prev = n;
+			}
+			return res;
+		}();
+		return chain;
+	}
+
+	// Frozen or not (see `TypeStore::freeze`) whatever ran before.
+	void set_frozen(bool frozen)
+	{
+		if (frozen)
+			thread_store().freeze();
+		else
+			thread_store().thaw();
+	}
+
+	void is_a_depth(State& state, size_t depth, bool frozen = false)
+	{
+		auto const& chain = abstract_chain();
+		TypeId sub = chain[depth], super = chain[0];
+		set_frozen(frozen);
+		state.resetTimer();
+
+		for (uint64_t i = 0; i < state.iterations; ++i)
+			keep(is_a(sub, super));
+	}
+}
+
+SYN_BENCHMARK(is_a_equal, "is_a/equal")
+{
+	TypeId t = type<core::Vector>::id();
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(is_a(t, t));
+}
+
+SYN_BENCHMARK(is_a_unrelated, "is_a/unrelated")
+{
+	TypeId a = type<core::Vector>::id(), b = type<std::string>::id();
+	set_frozen(false);
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(is_a(a, b));
+}
+
+SYN_BENCHMARK(is_a_depth_1, "is_a/depth/1") { is_a_depth(state, 1); }
+SYN_BENCHMARK(is_a_depth_4, "is_a/depth/4") { is_a_depth(state, 4); }
+SYN_BENCHMARK(is_a_depth_16, "is_a/depth/16") { is_a_depth(state, 16); }
+SYN_BENCHMARK(is_a_depth_64, "is_a/depth/64") { is_a_depth(state, 64); }
+SYN_BENCHMARK(is_a_frozen_64, "is_a/frozen/64") { is_a_depth(state, 64, true); }
+
+/******************************************************************************
+** QueryPlan
+******************************************************************************/
+
+namespace
+{
+	void query_plan_supers(State& state, bool frozen)
+	{
+		auto const& chain = abstract_chain();
+		auto const plan = QueryPlan().repeatOut(type<core::EIsA>::id());
+		QueryPlan::Scratch scratch;
+		set_frozen(frozen);
+		state.resetTimer();
+
+		for (uint64_t i = 0; i < state.iterations; ++i)
+			keep(plan.run(thread_store(), chain[64], scratch));
+	}
+}
+
+SYN_BENCHMARK(query_plan_supers_64, "query_plan/supers/64") { query_plan_supers(state, false); }
+SYN_BENCHMARK(query_plan_frozen_64, "query_plan/frozen/64") { query_plan_supers(state, true); }
+
+SYN_BENCHMARK(query_plan_memo_64, "query_plan/memo/64")
+{
+	auto const& chain = abstract_chain();
+	auto const plan = QueryPlan().repeatOut(type<core::EIsA>::id());
+	QueryPlan::Memo memo(plan);
+	set_frozen(false);
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(memo.run(thread_store(), chain[64]).size());
+}
+
+/******************************************************************************
+** basic_dispatch
+******************************************************************************/
+
+namespace
+{
+	// Every type `core::count` has a method for, more than fit in a default `CallSiteCache`.
+	std::vector<instance<>> const& count_receivers()
+	{
+		static std::vector<instance<>> receivers = {
+			instance<core::Vector>::make(),
+			instance<core::Set>::make(),
+			instance<core::ByteVector>::make(),
+			instance<core::Dictionary>::make(),
+			instance<core::StringDictionary>::make(),
+			instance<core::SymbolDictionary>::make(),
+		};
+		return receivers;
+	}
+
+	void basic_dispatch_over(State& state, size_t kinds)
+	{
+		std::vector<TypeId> types;
+		for (size_t i = 0; i < kinds; ++i)
+			types.push_back(count_receivers()[i].typeId());
+		state.resetTimer();
+
+		for (uint64_t i = 0; i < state.iterations; ++i)
+			keep(basic_dispatch(core::count, &types[i % kinds], 1));
+	}
+
+	void invoke_over(State& state, size_t kinds)
+	{
+		auto const& receivers = count_receivers();
+		state.resetTimer();
+
+		for (uint64_t i = 0; i < state.iterations; ++i)
+			keep(core::count.invoke<uint64_t>(receivers[i % kinds]));
+	}
+}
+
+SYN_BENCHMARK(basic_dispatch_mono, "basic_dispatch/mono") { basic_dispatch_over(state, 1); }
+SYN_BENCHMARK(basic_dispatch_poly, "basic_dispatch/poly") { basic_dispatch_over(state, 3); }
+SYN_BENCHMARK(basic_dispatch_mega, "basic_dispatch/mega") { basic_dispatch_over(state, 6); }
+
+/******************************************************************************
+** DispatchCache
+******************************************************************************/
+
+// Filling one cache with 4096 distinct tuples, per iteration, so the cost of growing it shows.
+SYN_BENCHMARK(dispatch_cache_fill_4096, "DispatchCache/fill/4096")
+{
+	std::vector<uint64_t> fake(4096);
+	for (uint64_t i = 0; i < state.iterations; ++i)
+	{
+		DispatchCache cache;
+		for (auto& f : fake)
+		{
+			TypeId arg = (Graph::Node*)&f;
+			cache.insert(1, &arg, 1, arg);
+		}
+		keep(cache.count());
+	}
+	Epoch::collect();
+}
+
+/******************************************************************************
+** Multimethod::invoke
+******************************************************************************/
+
+SYN_BENCHMARK(invoke_mono, "invoke/mono") { invoke_over(state, 1); }
+SYN_BENCHMARK(invoke_poly, "invoke/poly") { invoke_over(state, 3); }
+SYN_BENCHMARK(invoke_mega, "invoke/mega") { invoke_over(state, 6); }
+
+SYN_BENCHMARK(invoke_static, "invoke/static")
+{
+	core::Vector vector;
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(core::count.invoke<uint64_t>(vector));
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace syn_bench
+{
+	/******************************************************************************
+	** State
+	******************************************************************************/
+
+	// Passed to every benchmark, which must run its body `iterations` times.
+	struct State
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		uint64_t iterations;
+		Clock::time_point start;
+
+		// Excludes any setup done so far from the measurement.
+		inline void resetTimer() { start = Clock::now(); }
+	};
+
+	// Keeps the compiler from discarding a value computed by a benchmark.
+	template<typename T>
+	inline void keep(T const& value)
+	{
+#if defined(_MSC_VER)
+		static volatile char const* sink;
+		sink = reinterpret_cast<char const*>(&value);
+#else
+		asm volatile("" : : "g"(&value) : "memory");
+#endif
+	}
+
+	/******************************************************************************
+	** Registry
+	******************************************************************************/
+
+	typedef void (*Function)(State&);
+
+	struct Benchmark
+	{
+		std::string name;
+		Function function;
+	};
+
+	inline std::vector<Benchmark>& registry()
+	{
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	struct Registration
+	{
+		inline Registration(char const* name, Function function)
+		{
+			registry().push_back({ name, function });
+		}
+	};
+}
+
+#define SYN_BENCH_CONCAT_(a, b) a##b
+#define SYN_BENCH_CONCAT(a, b) SYN_BENCH_CONCAT_(a, b)
+
+// Defines a benchmark `func` reported as `name`, e.g. `SYN_BENCHMARK(is_a_equal, "is_a/equal") { ... }`.
+#define SYN_BENCHMARK(func, name) \
+	static void func(::syn_bench::State&); \
+	static ::syn_bench::Registration SYN_BENCH_CONCAT(_syn_bench_registration_, func)(name, &func); \
+	static void func(::syn_bench::State& state)
@@ -0,0 +1,67 @@
+#include "syn/common.h"
+#include "syn/syn.h"
+
+#include "bench/harness.h"
+
+using namespace syn;
+using namespace syn_bench;
+
+/******************************************************************************
+** instance lifecycle
+******************************************************************************/
+
+SYN_BENCHMARK(instance_make_destroy, "instance/make+destroy")
+{
+	for (uint64_t i = 0; i < state.iterations; ++i)
+	{
+		auto inst = instance<core::Vector>::make();
+		keep(inst);
+	}
+}
+
+SYN_BENCHMARK(instance_make_value, "instance/make+destroy (uint64_t)")
+{
+	for (uint64_t i = 0; i < state.iterations; ++i)
+	{
+		auto inst = instance<uint64_t>::make(i);
+		keep(inst);
+	}
+}
+
+SYN_BENCHMARK(instance_copy, "instance/copy")
+{
+	auto src = instance<core::Vector>::make();
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+	{
+		instance<core::Vector> copy = src;
+		keep(copy);
+	}
+}
+
+SYN_BENCHMARK(instance_copy_erased, "instance/copy (to instance<>)")
+{
+	auto src = instance<core::Vector>::make();
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+	{
+		instance<> copy = src;
+		keep(copy);
+	}
+}
+
+SYN_BENCHMARK(instance_move, "instance/move")
+{
+	auto a = instance<core::Vector>::make();
+	instance<core::Vector> b;
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+	{
+		b = std::move(a);
+		a = std::move(b);
+		keep(a);
+	}
+}
@@ -0,0 +1,263 @@
+#include "syn/common.h"
+#include "syn/syn.h"
+
+#include "bench/harness.h"
+
+#include <ctime>
+#include <iomanip>
+
+using namespace syn_bench;
+
+/******************************************************************************
+** Options
+******************************************************************************/
+
+struct Options
+{
+	std::string format = "text";
+	std::string filter;
+	std::string label;
+	std::string out;
+	double min_time = 0.1;
+	size_t repetitions = 5;
+	bool list = false;
+};
+
+static void usage()
+{
+	std::cerr
+		<< "usage: bench [options]" << std::endl
+		<< "  --format=text|json|csv  output format (default text)" << std::endl
+		<< "  --filter=SUBSTRING      only run benchmarks whose name contains SUBSTRING" << std::endl
+		<< "  --min-time=SECONDS      minimum time per repetition (default 0.1)" << std::endl
+		<< "  --repetitions=N         repetitions per benchmark (default 5)" << std::endl
+		<< "  --label=STRING          recorded in the output, e.g. a version or commit" << std::endl
+		<< "  --out=FILE              write results to FILE instead of stdout" << std::endl
+		<< "  --list                  list benchmark names and exit" << std::endl;
+}
+
+static Options parse(int argc, char** argv)
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		auto eq = arg.find('=');
+		auto key = arg.substr(0, eq);
+		auto value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+
+		if (key == "--format") options.format = value;
+		else if (key == "--filter") options.filter = value;
+		else if (key == "--label") options.label = value;
+		else if (key == "--out") options.out = value;
+		else if (key == "--min-time") options.min_time = std::stod(value);
+		else if (key == "--repetitions") options.repetitions = std::max<size_t>(1, std::stoul(value));
+		else if (key == "--list") options.list = true;
+		else
+		{
+			usage();
+			throw stdext::exception("unknown option `{0}`", arg);
+		}
+	}
+
+	if (options.format != "text" && options.format != "json" && options.format != "csv")
+		throw stdext::exception("unknown format `{0}`", options.format);
+
+	return options;
+}
+
+/******************************************************************************
+** Running
+******************************************************************************/
+
+struct Result
+{
+	std::string name;
+	uint64_t iterations;
+	std::vector<double> ns_per_op;
+
+	double min() const { return *std::min_element(ns_per_op.begin(), ns_per_op.end()); }
+	double max() const { return *std::max_element(ns_per_op.begin(), ns_per_op.end()); }
+	double mean() const
+	{
+		double sum = 0;
+		for (auto ns : ns_per_op) sum += ns;
+		return sum / ns_per_op.size();
+	}
+	double median() const
+	{
+		auto sorted = ns_per_op;
+		std::sort(sorted.begin(), sorted.end());
+		auto mid = sorted.size() / 2;
+		return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+	}
+};
+
+static double run_once(Benchmark const& bench, uint64_t iterations)
+{
+	State state;
+	state.iterations = iterations;
+	state.resetTimer();
+	bench.function(state);
+	auto end = State::Clock::now();
+
+	return std::chrono::duration<double>(end - state.start).count();
+}
+
+static Result run(Benchmark const& bench, Options const& options)
+{
+	// Grow the iteration count until a run takes a measurable fraction of the minimum time
+	uint64_t iterations = 1;
+	for (;;)
+	{
+		auto seconds = run_once(bench, iterations);
+		if (seconds >= options.min_time || iterations >= (uint64_t(1) << 40))
+			break;
+
+		auto scale = seconds <= 0 ? 100.0 : std::min(100.0, 1.4 * options.min_time / seconds);
+		iterations = std::max(iterations + 1, uint64_t(iterations * scale));
+	}
+
+	Result result { bench.name, iterations, {} };
+	for (size_t i = 0; i < options.repetitions; ++i)
+		result.ns_per_op.push_back(run_once(bench, iterations) * 1e9 / iterations);
+
+	return result;
+}
+
+/******************************************************************************
+** Reporting
+******************************************************************************/
+
+static std::string json_string(std::string const& s)
+{
+	std::string res = "\"";
+	for (auto c : s)
+	{
+		if (c == '"' || c == '\\') { res += '\\'; res += c; }
+		else if ((unsigned char)c < 0x20) res += ' ';
+		else res += c;
+	}
+	return res + "\"";
+}
+
+static std::string timestamp()
+{
+	auto now = std::time(nullptr);
+	char buf[32];
+	std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+	return buf;
+}
+
+static std::string compiler()
+{
+#if defined(__clang__)
+	return "clang " __clang_version__;
+#elif defined(__GNUC__)
+	return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+	return "msvc " + std::to_string(_MSC_VER);
+#else
+	return "unknown";
+#endif
+}
+
+static void report(std::ostream& os, Options const& options, std::vector<Result> const& results)
+{
+	os << std::fixed << std::setprecision(2);
+
+	if (options.format == "json")
+	{
+		os << "{" << std::endl
+			<< "  \"context\": {" << std::endl
+			<< "    \"label\": " << json_string(options.label) << "," << std::endl
+			<< "    \"date\": " << json_string(timestamp()) << "," << std::endl
+			<< "    \"compiler\": " << json_string(compiler()) << "," << std::endl
+			<< "    \"repetitions\": " << options.repetitions << std::endl
+			<< "  }," << std::endl
+			<< "  \"benchmarks\": [";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			auto const& r = results[i];
+			os << (i ? "," : "") << std::endl
+				<< "    { \"name\": " << json_string(r.name)
+				<< ", \"iterations\": " << r.iterations
+				<< ", \"ns_min\": " << r.min()
+				<< ", \"ns_median\": " << r.median()
+				<< ", \"ns_mean\": " << r.mean()
+				<< ", \"ns_max\": " << r.max() << " }";
+		}
+		os << std::endl << "  ]" << std::endl << "}" << std::endl;
+	}
+	else if (options.format == "csv")
+	{
+		os << "label,name,iterations,ns_min,ns_median,ns_mean,ns_max" << std::endl;
+		for (auto const& r : results)
+			os << options.label << "," << r.name << "," << r.iterations << ","
+				<< r.min() << "," << r.median() << "," << r.mean() << "," << r.max() << std::endl;
+	}
+	else
+	{
+		os << std::left << std::setw(48) << "benchmark" << std::right
+			<< std::setw(14) << "median ns" << std::setw(14) << "min ns" << std::setw(14) << "max ns"
+			<< std::setw(14) << "iterations" << std::endl;
+		for (auto const& r : results)
+			os << std::left << std::setw(48) << r.name << std::right
+				<< std::setw(14) << r.median() << std::setw(14) << r.min() << std::setw(14) << r.max()
+				<< std::setw(14) << r.iterations << std::endl;
+	}
+}
+
+/******************************************************************************
+** main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		auto options = parse(argc, argv);
+
+		auto benchmarks = registry();
+		std::sort(benchmarks.begin(), benchmarks.end(),
+			[](Benchmark const& a, Benchmark const& b) { return a.name < b.name; });
+
+		if (options.list)
+		{
+			for (auto const& bench : benchmarks)
+				std::cout << bench.name << std::endl;
+			return 0;
+		}
+
+		syn::dll::boot();
+
+		std::vector<Result> results;
+		for (auto const& bench : benchmarks)
+		{
+			if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos)
+				continue;
+
+			results.push_back(run(bench, options));
+			if (!options.out.empty() || options.format != "text")
+				std::cerr << bench.name << ": " << results.back().median() << " ns" << std::endl;
+		}
+
+		if (options.out.empty())
+			report(std::cout, options, results);
+		else
+		{
+			std::ofstream file(options.out);
+			if (!file)
+				throw stdext::exception("could not open `{0}`", options.out);
+			report(file, options, results);
+		}
+	}
+	catch (std::exception const& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include "syn/common.h"
+#include "syn/syn.h"
+
+#include "bench/harness.h"
+
+using namespace syn;
+using namespace syn_bench;
+
+/******************************************************************************
+** TypeStore, parallel init
+******************************************************************************/
+
+namespace
+{
+	// Roughly what initers do: mostly lookups (is-a, props, edges), now and then a change. The
+	// workers share one store as initers share the global one, and split the iterations between
+	// them, so with lookups lock free the time per iteration falls with the thread count.
+	void parallel_init(State& state, size_t threads)
+	{
+		TypeStore store;
+		auto symbol = store.s().require("bench/parallel_init");
+
+		std::vector<Graph::Node*> chain;
+		for (size_t i = 0; i <= 16; ++i)
+		{
+			auto n = store.addNode<core::NAbstract>({ });
+			store.addProp<core::PModuleSymbol>({ symbol }, n);
+			if (!chain.empty())
+				store.addIsA(n, chain.back());
+			chain.push_back(n);
+		}
+		state.resetTimer();
+
+		auto work = [&](size_t first)
+		{
+			size_t found = 0;
+			for (uint64_t i = first; i < state.iterations; i += threads)
+			{
+				auto n = chain[i % chain.size()];
+				found += store.isA(chain.back(), n);
+				found += store.isA(n, chain.back());
+				found += store.onlyPropOfTypeOnNode<core::PModuleSymbol>(n) != nullptr;
+				store.forAllEdgesOnNode(n, [&](auto e) { found += 1; });
+
+				// Off the chain, so the lookups above cost the same throughout
+				if (i % 64 == 0)
+					store.addProp<core::PModuleSymbol>({ symbol }, store.addNode<core::NAbstract>({ }));
+			}
+			keep(found);
+		};
+
+		std::vector<std::thread> workers;
+		for (size_t t = 1; t < threads; ++t)
+			workers.emplace_back(work, t);
+		work(0);
+		for (auto& worker : workers)
+			worker.join();
+	}
+}
+
+SYN_BENCHMARK(parallel_init_1, "store/parallel_init/1") { parallel_init(state, 1); }
+SYN_BENCHMARK(parallel_init_2, "store/parallel_init/2") { parallel_init(state, 2); }
+SYN_BENCHMARK(parallel_init_4, "store/parallel_init/4") { parallel_init(state, 4); }
+SYN_BENCHMARK(parallel_init_8, "store/parallel_init/8") { parallel_init(state, 8); }
@@ -0,0 +1,119 @@
+#include "syn/common.h"
+#include "syn/syn.h"
+
+#include "bench/harness.h"
+
+using namespace syn;
+using namespace syn_bench;
+
+/******************************************************************************
+** SymbolTable
+******************************************************************************/
+
+namespace
+{
+	std::vector<std::string> const& symbol_names()
+	{
+		static std::vector<std::string> names = []()
+		{
+			std::vector<std::string> res;
+			for (size_t i = 0; i < 1024; ++i)
+				res.push_back("bench/symbol/" + std::to_string(i));
+			return res;
+		}();
+		return names;
+	}
+}
+
+SYN_BENCHMARK(symbols_require_existing, "SymbolTable/require (existing)")
+{
+	auto const& names = symbol_names();
+	auto& symbols = global_store().s();
+	for (auto const& name : names)
+		symbols.require(name);
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(symbols.require(names[i % names.size()]));
+}
+
+SYN_BENCHMARK(symbols_require_new, "SymbolTable/require (new)")
+{
+	SymbolTable symbols;
+	std::vector<std::string> names;
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		names.push_back("bench/new/" + std::to_string(i));
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(symbols.require(names[i]));
+}
+
+SYN_BENCHMARK(symbols_get_string, "SymbolTable/getString")
+{
+	auto const& names = symbol_names();
+	auto& symbols = global_store().s();
+	std::vector<Symbol> ids;
+	for (auto const& name : names)
+		ids.push_back(symbols.require(name));
+	state.resetTimer();
+
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(symbols.getString(ids[i % ids.size()]));
+}
+
+SYN_BENCHMARK(symbols_literal, "SymbolTable/require (literal)")
+{
+	auto& symbols = global_store().s();
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(symbols.require("bench/symbol/0"_sym));
+}
+
+SYN_BENCHMARK(symbols_cached_literal, "SYN_SYMBOL")
+{
+	for (uint64_t i = 0; i < state.iterations; ++i)
+		keep(SYN_SYMBOL("bench/symbol/0"));
+}
+
+/******************************************************************************
+** Snapshot
+******************************************************************************/
+
+/* What a symbol snapshot saves a boot: interning the same names into a fresh table, with and
+   without seeding it from an image first. Only symbols are snapshotted, so this is all of it.
+*/
+
+namespace
+{
+	void snapshot_intern(State& state, bool seeded)
+	{
+		std::vector<std::string> names;
+		for (size_t i = 0; i < 4096; ++i)
+			names.push_back("bench/snapshot/" + std::to_string(i));
+
+		auto path = (std::filesystem::temp_directory_path() / "syn_bench_symbols.snapshot").string();
+		{
+			TypeStore store;
+			for (auto const& name : names)
+				store.s().require(name);
+			Snapshot::write(path, store, 0);
+		}
+		auto image = Snapshot::open(path);
+		state.resetTimer();
+
+		for (uint64_t i = 0; i < state.iterations; ++i)
+		{
+			TypeStore store;
+			if (seeded)
+				image->seed(store);
+			for (auto const& name : names)
+				keep(store.s().require(name));
+		}
+
+		image = nullptr;
+		std::filesystem::remove(path);
+	}
+}
+
+SYN_BENCHMARK(snapshot_intern_4096, "Snapshot/intern 4096") { snapshot_intern(state, false); }
+SYN_BENCHMARK(snapshot_seeded_4096, "Snapshot/intern 4096 (seeded)") { snapshot_intern(state, true); }
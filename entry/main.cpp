@@ -42,7 +42,18 @@ int main(int argc, char** argv)
 			{
 				if (has_args)
 				{
-
+					auto dump = [](Graph::Node const* n)
+					{
+						std::cout << std::string(80, '=') << std::endl;
+						std::cout << global_store().describeNode(n) << std::endl;
+					};
+
+					if (args == "abstracts") global_store().forAllNodesOfType<core::NAbstract>(dump);
+					else if (args == "structs") global_store().forAllNodesOfType<core::NStruct>(dump);
+					else if (args == "dispatchers") global_store().forAllNodesOfType<core::NDispatcher>(dump);
+					else if (args == "functions") global_store().forAllNodesOfType<core::NFunction>(dump);
+					else
+						std::cout << "dump [abstracts|structs|dispatchers|functions]" << std::endl;
 				}
 				else
 				{
@@ -90,6 +101,35 @@ int main(int argc, char** argv)
 				}
 				std::cout << "." << std::endl;
 			}
+			else if (input == "stats")
+			{
+				if (!dispatch_stats_enabled())
+				{
+					std::cout << "dispatch stats are not compiled in, build with `--define syn_dispatch_stats=on`." << std::endl;
+				}
+				else if (has_args && args == "reset")
+				{
+					reset_dispatch_stats();
+					std::cout << "dispatch stats reset." << std::endl;
+				}
+				else
+				{
+					forAllDispatchStats(
+						[](TypeId dispatcher, DispatchStats const& stats)
+					{
+						if (stats.calls == 0 && stats.dispatches == 0)
+							return;
+
+						std::cout << dispatcher.toString() << std::endl
+							<< "  calls: " << stats.calls << " (call site hits: " << stats.site_hits << ")" << std::endl
+							<< "  dispatches: " << stats.dispatches << " (cache hits: " << stats.cache_hits
+								<< ", misses: " << stats.cache_misses << ")" << std::endl
+							<< "  distinct argument types: " << stats.distinct_tuples << std::endl
+							<< "  dispatch latency: p50 < " << stats.latencyPercentile(0.5) << "ns, p99 < "
+								<< stats.latencyPercentile(0.99) << "ns" << std::endl;
+					});
+				}
+			}
 			else if (input == "load")
 			{
 				auto abs = std::filesystem::absolute(args);
@@ -15,6 +15,14 @@ namespace syn
     template<> struct type_define<::syn::Symbol> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::Symbol> Definition; };
 }
 /******************************************************************************
+** /syn/system/TypeId.h
+******************************************************************************/
+namespace syn
+{
+    // Defined in /syn/system/TypeId.cpp
+    template<> struct type_define<::syn::TypeId> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::TypeId> Definition; };
+}
+/******************************************************************************
 ** /syn/core/system_graph.h
 ******************************************************************************/
 namespace syn
@@ -49,7 +57,11 @@ namespace syn
 namespace syn
 {
     template<> struct type_define<::syn::core::NDispatcher> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::NDispatcher> Definition; };
+    template<> struct type_define<::syn::core::EUsingDispatcherFunction> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::EUsingDispatcherFunction> Definition; };
+    template<> struct type_define<::syn::core::PDispatchArguments> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::PDispatchArguments> Definition; };
     template<> struct type_define<::syn::core::PCompositionalCast> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::PCompositionalCast> Definition; };
+    template<> struct type_define<::syn::core::NValueSpecializer> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::NValueSpecializer> Definition; };
+    template<> struct type_define<::syn::core::ESpecializesArgument> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::ESpecializesArgument> Definition; };
 }
 
 /******************************************************************************
@@ -68,6 +80,7 @@ namespace syn
 namespace syn
 {
     template<> struct type_define<::syn::core::PCppDefine> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::PCppDefine> Definition; };
+    template<> struct type_define<::syn::core::PCppGenericCall> { CULTLANG_SYNDICATE_EXPORTED static syn::Define<::syn::core::PCppGenericCall> Definition; };
 }
 
 /******************************************************************************
@@ -4,6 +4,8 @@
 
 // C++
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <filesystem>
 #include <regex>
 #include <fstream>
@@ -11,7 +13,11 @@
 #include <sstream>
 #include <utility>
 #include <vector>
+#include <array>
+#include <cstddef>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <iterator>
 #include <stack>
@@ -20,8 +26,11 @@
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
 #include <type_traits>
 #include <functional>
+#include <optional>
 
 #ifndef _WIN32
 #include <dlfcn.h>
@@ -10,3 +10,8 @@ decltype(syn::type_define<::syn::core::PCppDefine>::Definition) syn::type_define
 	[](auto _) {
 		_.name("C++Define");
 	});
+
+decltype(syn::type_define<::syn::core::PCppGenericCall>::Definition) syn::type_define<::syn::core::PCppGenericCall>::Definition(
+	[](auto _) {
+		_.name("C++GenericCall");
+	});
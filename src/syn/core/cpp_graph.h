@@ -21,6 +21,23 @@ namespace core
         CppDefine* define;
 	};
 
+	/******************************************************************************
+	** PCppGenericCall (NStruct)
+	******************************************************************************/
+
+	// Placed on a C++ function, calls it's `NFunction::fptr` with a generic argument pack.
+	struct PCppGenericCall final
+	{
+    public:
+        instance<> (*call)(void (*fptr)(), GenericInvoke& invoke);
+
+        // Calls with pointers to exactly typed arguments, writing into `result` if it isn't null.
+        // Null when the function takes instances (which can't be made from raw pointers).
+        void (*direct)(void (*fptr)(), void* result, void** args);
+        // What `direct` writes into `result`, `None` if that is not a (non pointer) defined type.
+        TypeId returns;
+	};
+
 }}
 #ifdef __clang__
 #pragma clang diagnostic pop
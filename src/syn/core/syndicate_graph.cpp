@@ -11,6 +11,26 @@ decltype(syn::type_define<::syn::core::NDispatcher>::Definition) syn::type_defin
 		_.name("Dispatcher");
 	});
 
+decltype(syn::type_define<::syn::core::EUsingDispatcherFunction>::Definition) syn::type_define<::syn::core::EUsingDispatcherFunction>::Definition(
+	[](auto _) {
+		_.name("UsingDispatcherFunction");
+	});
+
+decltype(syn::type_define<::syn::core::PDispatchArguments>::Definition) syn::type_define<::syn::core::PDispatchArguments>::Definition(
+	[](auto _) {
+		_.name("DispatchArguments");
+	});
+
+decltype(syn::type_define<::syn::core::NValueSpecializer>::Definition) syn::type_define<::syn::core::NValueSpecializer>::Definition(
+	[](auto _) {
+		_.name("ValueSpecializer");
+	});
+
+decltype(syn::type_define<::syn::core::ESpecializesArgument>::Definition) syn::type_define<::syn::core::ESpecializesArgument>::Definition(
+	[](auto _) {
+		_.name("SpecializesArgument");
+	});
+
 decltype(syn::type_define<::syn::core::PCompositionalCast>::Definition) syn::type_define<::syn::core::PCompositionalCast>::Definition(
 	[](auto _) {
 		_.name("CompositionalCast");
@@ -32,6 +32,42 @@ namespace core
 		uintptr_t _reserved;
 	};
 	
+	/******************************************************************************
+	** PDispatchArguments (typenode NStruct)
+	******************************************************************************/
+
+	// Placed on a function to describe the argument types it is dispatched on, `None` matches anything.
+	struct PDispatchArguments final
+	{
+	public:
+		std::vector<TypeId> types;
+	};
+
+	/******************************************************************************
+	** NValueSpecializer (typenode NStruct)
+	******************************************************************************/
+
+	// Restricts a function to calls where an argument equals a value, by it's `value_key`.
+	struct NValueSpecializer final
+	{
+	public:
+		size_t argument;
+		TypeId type;
+		uint64_t key;
+	};
+
+	/******************************************************************************
+	** ESpecializesArgument (typenode NEmpty)
+	******************************************************************************/
+
+	// From a function to each of it's `NValueSpecializer`s.
+	struct ESpecializesArgument final
+	{
+	private:
+		// Unused
+		uintptr_t _reserved;
+	};
+
 	/******************************************************************************
 	** PCompositionalCast (typenode NStruct)
 	******************************************************************************/
@@ -24,10 +24,21 @@ namespace syn
 			EntryKind kind;
 		};
 
+		// A define as it was inserted, kept since a library's defines go away when it is unloaded.
+		// The key (see `_init_adoptEntries`) is taken while the define is still loaded.
+		struct _Defined
+		{
+			CppDefine const* define;
+			CppDefineKind kind;
+			Graph::Node* node;
+			std::string key;
+		};
+
 		struct _Entries
 		{
 			std::string name;
 			std::vector<_Entry> entries;
+			std::vector<_Defined> defined;
 		};
 
 	private:
@@ -44,9 +55,18 @@ namespace syn
 		std::map<std::string, size_t> _dllNames;
 		std::set<std::string> _dllsToUpdate;
 		std::set<std::string> _dllsThatWereStatic;
+		// The entries of loaded libraries that were loaded again, replaced on the next update
+		std::map<std::string, _Entries*> _dllsToReload;
+		// The handle `dll::load` (or `dll::reload`) opened each library with, by normalized path
+		std::map<std::string, void*> _dllHandles;
 
 		std::string _lastLoadedDll;
 
+		// Initers run on this many threads, see `setInitThreads`
+		size_t _initThreads;
+		// Initers of defines with a node are deferred until the node is required, see `setLazyInit`
+		bool _lazyInit;
+
 		// 
 		// Lifecycle
 		//
@@ -59,20 +79,25 @@ namespace syn
 
 	private:
 		friend inline void ::syn::dll::boot();
+		friend inline void ::syn::dll::boot(std::string const&);
 		friend inline void ::syn::dll::update();
 		friend inline void ::syn::dll::reset();
 		friend inline char const* ::syn::dll::_begin(char const*);
 		friend inline void ::syn::dll::_finish(char const*, char const*);
 
 		friend inline void ::syn::dll::load(std::string const&);
+		friend inline void ::syn::dll::reload(std::string const&);
 
 		void _init_primeInternalEntries();
 		void _init_insertEntries(_Entries* entries, size_t start);
 		void _init_runEntries(_Entries* entries, size_t start);
+		void _init_adoptEntries(_Entries* old, _Entries* entries);
+		void _retireEntries(_Entries* entries);
 
 		static char const* __dll_region;
 
-		CULTLANG_SYNDICATE_EXPORTED void _init();
+		// Seeds the store from (and refreshes) the snapshot at `snapshot` when given.
+		CULTLANG_SYNDICATE_EXPORTED void _init(char const* snapshot = nullptr);
 		CULTLANG_SYNDICATE_EXPORTED bool _hasInited();
 		CULTLANG_SYNDICATE_EXPORTED static char const* _begin(char const* name);
 		CULTLANG_SYNDICATE_EXPORTED void _finish(char const* save, char const* name);
@@ -93,6 +118,22 @@ namespace syn
 
 		CULTLANG_SYNDICATE_EXPORTED void _register(CppDefine const*);
 
+		// Runs initers (at boot and on library load) on `threads` threads, 0 for one per core.
+		//
+		// Nodes for every define are created before any initer runs, and every change and lookup
+		// initers make goes through the `TypeStore`, so initers may run in any order. Changes
+		// serialize on the store's write lock, lookups are lock free. Defaults to 1.
+		CULTLANG_SYNDICATE_EXPORTED void setInitThreads(size_t threads);
+
+		// Defers the initer of every define with a node until the `TypeStore` requires that node
+		// (its props are looked up, it is dispatched on or through, or it's subtypes are checked),
+		// see `TypeStore::defer`. Defines without a node still run at boot. Defaults to false.
+		CULTLANG_SYNDICATE_EXPORTED void setLazyInit(bool lazy);
+
+		// A hash of every registered entry (kinds, markers and library names) in order, with each
+		// define's offset into it's binary and the path, size and modification time of the binary.
+		CULTLANG_SYNDICATE_EXPORTED uint64_t fingerprint() const;
+
 		//
 		// Entries and DLLs
 		//
@@ -52,6 +52,11 @@ namespace details
             return global_store().g();
         }
 
+        inline TypeStore& store()
+        {
+            return global_store();
+        }
+
         inline Graph::Node* node()
         {
             auto n = actual().define->node;
@@ -74,13 +79,14 @@ namespace details
         typedef DefineHelperLibraryBase<TFinal, DefineHelperLibraryNaming<TFinal>> Base;
 		using Base::g;
 		using Base::s;
+		using Base::store;
 		using Base::node;
 
     public:
         inline DefineHelperLibraryNaming& name(std::string const& name)
         {
             auto sym = s().require(name);
-            g().template addProp<core::PModuleSymbol>({ sym }, node());
+            store().template addProp<core::PModuleSymbol>({ sym }, node());
             return *this;
         }
         inline DefineHelperLibraryNaming& space(std::string const& name)
@@ -107,12 +113,13 @@ namespace details
         typedef DefineHelperLibraryBase<TFinal, DefineHelperLibraryTyping<TFinal>> Base;
 		using Base::g;
 		using Base::s;
+		using Base::store;
 		using Base::node;
 
     public:
         inline void subtypes(syn::Abstract const& abstract_)
         {
-            g().template addEdge<core::EIsA>({ }, { node(), abstract_.node });
+            store().addIsA(node(), abstract_.node);
         }
     };
 
@@ -135,17 +142,24 @@ namespace details
 			}
 
             template<auto PFunc, typename TDefine>
-            static inline void _exec(TDefine* define)
+            static inline Graph::Node* _exec(TDefine* define)
             {
 				void (*fnptr)() = reinterpret_cast<void (*)()>( (TReturn (*)(TClassType*, TArgs...))&_trampoline<PFunc> );
-                auto n = define->g().template addNode<core::NFunction>({ fnptr });
+                auto n = define->store().template addNode<core::NFunction>({ fnptr });
+                define->store().template addProp<core::PDispatchArguments>({ { type<TClassType>::id(), cpp_dispatch_type<TArgs>::id()... } }, n);
+                define->store().template addProp<core::PCppGenericCall>({
+                        &cpp_generic_call<TReturn, TClassType*, TArgs...>,
+                        cpp_direct_call_for<TReturn, TClassType*, TArgs...>(),
+                        cpp_direct_return_type<TReturn>()
+                    }, n);
+                return n;
             }
         };
         template<typename TClassType>
         struct _t_register_class_function <TClassType, void, void>
         {
             template<auto PFunc, typename TDefine>
-            static inline void _exec(TDefine* define)
+            static inline Graph::Node* _exec(TDefine* define)
             {
                 return _t_register_class_function<
                         TClassType,
@@ -164,6 +178,7 @@ namespace details
         typedef DefineHelperLibraryBase<TFinal, DefineHelperLibraryStructure<TFinal, TType>> Base;
 		using Base::g;
 		using Base::s;
+		using Base::store;
 		using Base::node;
 
 		template<typename TClassType, typename TReturn, typename TArgs> friend struct _details::_t_register_class_function;
@@ -195,7 +210,8 @@ namespace details
         inline typename std::enable_if<TMulti::kind == CppDefineKind::Dispatcher,
             void>::type method(TMulti& method)
         {
-            _details::_t_register_class_function<TType>::template _exec<PMethod>(this);
+            auto n = _details::_t_register_class_function<TType>::template _exec<PMethod>(this);
+            store().addMethod(method.node, n);
         }
         
         template<typename FMethod>
@@ -216,15 +232,15 @@ namespace details
         inline typename std::enable_if<syn::type<TOtherType>::kind == CppDefineKind::Struct,
             void>::type inherits()
         {
-            auto e = g().template addEdge<core::EIsA>({ }, { node(), syn::type<TOtherType>::graphNode() });
-            g().template addProp<core::PCompositionalCast>({ _inherits_offset<TOtherType>() }, e);
+            auto e = store().addIsA(node(), const_cast<Graph::Node*>(syn::type<TOtherType>::graphNode()));
+            store().template addProp<core::PCompositionalCast>({ _inherits_offset<TOtherType>() }, e);
         }
 
         template<typename TOtherType>
         inline typename std::enable_if<syn::type<TOtherType>::kind == CppDefineKind::Struct,
             void>::type implements()
         {
-            auto e = g().template addEdge<core::EIsA>({ }, { node(), syn::type<TOtherType>::graphNode() });
+            auto e = store().addIsA(node(), const_cast<Graph::Node*>(syn::type<TOtherType>::graphNode()));
             //g().template addProp<core::PCompositionalCast>({ _inherits_offset<TOtherType>() }, e);
         }
 
@@ -285,14 +301,45 @@ namespace details
         typedef DefineHelperLibraryBase<TFinal, DefineHelperLibraryMultimethod<TFinal>> Base;
 		using Base::g;
 		using Base::s;
+		using Base::store;
 		using Base::node;
 
+    protected:
+        template<typename TReturn, typename... TArgs>
+        inline Graph::Node* _method(TReturn (*fptr)(TArgs...))
+        {
+            auto n = store().template addNode<core::NFunction>({ reinterpret_cast<void (*)()>(fptr) });
+            store().template addProp<core::PDispatchArguments>({ { cpp_dispatch_type<TArgs>::id()... } }, n);
+            store().template addProp<core::PCppGenericCall>({
+                    &cpp_generic_call<TReturn, TArgs...>,
+                    cpp_direct_call_for<TReturn, TArgs...>(),
+                    cpp_direct_return_type<TReturn>()
+                }, n);
+            store().addMethod(node(), n);
+            return n;
+        }
+
     public:
         template<typename TMethodType>
         inline typename std::enable_if<true,
             void>::type method(TMethodType methptr)
         {
-            
+            // Plain functions and capture-less lambdas
+            _method(static_cast<std::add_pointer_t<boost::callable_traits::function_type_t<TMethodType>>>(methptr));
+        }
+
+        // A method only applying when argument `TIndex` equals `value` (a symbol, integer or type
+        // id), e.g. `_.template methodForValue<0>(TypeId(...), [](TypeId t, ...) { ... })`.
+        template<size_t TIndex, typename TValue, typename TMethodType>
+        inline void methodForValue(TValue const& value, TMethodType methptr)
+        {
+            using Function = boost::callable_traits::function_type_t<TMethodType>;
+            using Argument = std::remove_cv_t<std::remove_reference_t<std::tuple_element_t<TIndex, boost::callable_traits::args_t<Function>>>>;
+            static_assert(std::is_same_v<Argument, TValue>, "The specialized argument must take the value's type.");
+            static_assert(value_dispatchable<TValue>::value, "Only the types `ValueDispatch::keyFunction` reads (symbols, fixed width integers and type ids) can be value dispatched.");
+
+            auto n = _method(static_cast<std::add_pointer_t<Function>>(methptr));
+            store().addValueSpecializer(n, TIndex, type<TValue>::id(), value_key(value));
         }
     };
 
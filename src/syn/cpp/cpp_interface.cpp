@@ -13,6 +13,8 @@ using namespace syn;
 ******************************************************************************/
 
 CppSystem::CppSystem()
+	: _initThreads(1)
+	, _lazyInit(false)
 {
 	_staticEntries = new _Entries();
 	_addEntry({ new std::string("cpp-static-init-begin"), EntryKind::Marker });
@@ -58,6 +60,22 @@ void CppSystem::_init_primeInternalEntries()
 	*/
 }
 
+namespace
+{
+	// The linker name of `define`, if it's binary exports one for exactly it. Unlike it's address
+	// or position it stays the same across builds of a library, so a reload can tell which of the
+	// old defines a new one is. Empty when there is none (and on Windows).
+	std::string symbol_of(CppDefine const* define)
+	{
+#ifndef _WIN32
+		Dl_info info;
+		if (dladdr(define, &info) != 0 && info.dli_sname != nullptr && info.dli_saddr == define)
+			return info.dli_sname;
+#endif
+		return "";
+	}
+}
+
 void CppSystem::_init_insertEntries(_Entries* entries, size_t start)
 {
 	//std::cerr << "CppSystem::_init_insertEntries:" << entries->_entries.size() << std::endl;
@@ -69,9 +87,14 @@ void CppSystem::_init_insertEntries(_Entries* entries, size_t start)
 			case EntryKind::StaticDefine:
 			{
 				auto* sd = (CppDefine*)entry.ptr;
-				// Was pre-initalized
+				entries->defined.push_back({ sd, sd->kind, nullptr, entries != _staticEntries ? symbol_of(sd) : "" });
+
+				// Was pre-initalized (or adopted, see `_init_adoptEntries`)
 				if (sd->node != nullptr)
+				{
+					entries->defined.back().node = sd->node;
 					continue;
+				}
 
 				sd->node = nullptr;
 
@@ -82,15 +105,15 @@ void CppSystem::_init_insertEntries(_Entries* entries, size_t start)
 						break;
 					case CppDefineKind::Abstract:
 					{
-						sd->node = _store->g().addNode<core::NAbstract>({ });
+						sd->node = _store->addNode<core::NAbstract>({ });
 					} break;
 					case CppDefineKind::Struct:
 					{
-						sd->node = _store->g().addNode<core::NStruct>({ });
+						sd->node = _store->addNode<core::NStruct>({ });
 					} break;
 					case CppDefineKind::Dispatcher:
 					{
-						sd->node = _store->g().addNode<core::NDispatcher>({ });
+						sd->node = _store->addNode<core::NDispatcher>({ });
 					} break;
 					case CppDefineKind::Module:
 					{
@@ -100,15 +123,18 @@ void CppSystem::_init_insertEntries(_Entries* entries, size_t start)
 
 				if (sd->node != nullptr)
 				{
-					_store->g().addProp<core::PCppDefine>({ sd }, sd->node);
+					TypeStore::Source source(sd);
+					_store->addProp<core::PCppDefine>({ sd }, sd->node);
 
 					// if it was named, add it to the module
-					auto sym_prop = _store->g().onlyPropOfTypeOnNode<core::PModuleSymbol>(sd->node);
+					auto sym_prop = _store->onlyPropOfTypeOnNode<core::PModuleSymbol>(sd->node);
 					if (sym_prop != nullptr)
 					{
 						
 					}
 				}
+
+				entries->defined.back().node = sd->node;
 			} break;
 
 			default: break;
@@ -119,6 +145,7 @@ void CppSystem::_init_insertEntries(_Entries* entries, size_t start)
 void CppSystem::_init_runEntries(_Entries* entries, size_t start)
 {
 	//std::cerr << "CppSystem::_init_runEntries:" << entries->_entries.size() << std::endl;
+	std::vector<CppDefine*> defines;
 	for (auto i = start; i < entries->entries.size(); ++i)
 	{
 		auto& entry = entries->entries[i];
@@ -130,14 +157,156 @@ void CppSystem::_init_runEntries(_Entries* entries, size_t start)
 
 				if (td->initer == nullptr) continue;
 
-				details::DefineHelper<void> helper(td);
-				td->initer(helper);
+				defines.push_back(td);
 			} break;
 		}
 	}
+
+	auto run = [](void* td)
+	{
+		TypeStore::Source source(td);
+		details::DefineHelper<void> helper((CppDefine*)td);
+		((CppDefine*)td)->initer(helper);
+	};
+
+	if (_lazyInit)
+	{
+		auto deferred = std::remove_if(defines.begin(), defines.end(), [&](CppDefine* td)
+		{
+			if (td->node == nullptr)
+				return false;
+
+			TypeStore::Source source(td);
+			_store->defer(td->node, run, td);
+			return true;
+		});
+		defines.erase(deferred, defines.end());
+	}
+
+	auto threads = std::min(_initThreads, defines.size());
+	if (threads <= 1)
+	{
+		for (auto td : defines)
+			run(td);
+		return;
+	}
+
+	// Workers take the next define until none are left, the first error is rethrown once all stop
+	std::atomic<size_t> next { 0 };
+	std::exception_ptr error;
+	std::mutex error_lock;
+	auto work = [&]()
+	{
+		for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < defines.size(); )
+		{
+			try
+			{
+				run(defines[i]);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(error_lock);
+				if (!error)
+					error = std::current_exception();
+				next.store(defines.size(), std::memory_order_relaxed);
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < threads; ++i)
+		workers.emplace_back(work);
+	work();
+	for (auto& worker : workers)
+		worker.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void CppSystem::_init_adoptEntries(_Entries* old, _Entries* entries)
+{
+	// The old defines are gone with the old library, only what was kept of them may be used
+	for (auto const& defined : old->defined)
+		_store->retire(defined.define);
+
+	// Defines take the node of the old define with the same key, so type ids held by other
+	// libraries (their dispatch arguments and is-a edges) stay valid. The key is the define's
+	// symbol, or for those without one their kind and position among the others without one
+	std::vector<CppDefine*> defines;
+	for (auto& entry : entries->entries)
+		if (entry.kind == EntryKind::StaticDefine)
+			defines.push_back((CppDefine*)entry.ptr);
+
+	std::map<std::string, std::pair<CppDefineKind, Graph::Node*>> nodes;
+	std::map<CppDefineKind, size_t> old_positions, positions;
+	bool lined_up = true;
+	for (auto const& defined : old->defined)
+	{
+		auto key = !defined.key.empty() ? defined.key : fmt::format("#{0}:{1}", (int)defined.kind, old_positions[defined.kind]++);
+		lined_up &= nodes.emplace(key, std::make_pair(defined.kind, defined.node)).second;
+	}
+
+	std::vector<std::pair<CppDefine*, Graph::Node*>> adopted;
+	std::set<std::string> keys;
+	std::set<Graph::Node*> kept;
+	for (auto sd : defines)
+	{
+		auto key = symbol_of(sd);
+		if (key.empty())
+			key = fmt::format("#{0}:{1}", (int)sd->kind, positions[sd->kind]++);
+		lined_up &= keys.insert(key).second;
+
+		auto it = nodes.find(key);
+		if (it == nodes.end())
+			continue;
+
+		lined_up &= it->second.first == sd->kind;
+		adopted.push_back({ sd, it->second.second });
+		kept.insert(it->second.second);
+	}
+
+	// Positions only tell which define is which if as many of each kind lack a symbol as before
+	lined_up &= positions == old_positions;
+
+	if (!lined_up)
+	{
+		_addEntry({ new std::string(fmt::format("library `{0}` reloaded with defines that don't match the old ones, "
+			"it's types were defined anew (type ids held elsewhere are retired)", entries->name)), EntryKind::Warning });
+		for (auto const& defined : old->defined)
+			if (defined.node != nullptr)
+				_store->retireNode(defined.node);
+		return;
+	}
+
+	for (auto const& adopt : adopted)
+	{
+		auto sd = adopt.first;
+		sd->node = adopt.second;
+		if (sd->node != nullptr)
+		{
+			TypeStore::Source source(sd);
+			_store->addProp<core::PCppDefine>({ sd }, sd->node);
+		}
+	}
+
+	// Defines the new library no longer has
+	for (auto const& defined : old->defined)
+		if (defined.node != nullptr && kept.count(defined.node) == 0)
+			_store->retireNode(defined.node);
+}
+
+void CppSystem::_retireEntries(_Entries* entries)
+{
+	for (auto const& defined : entries->defined)
+	{
+		_store->retire(defined.define);
+		if (defined.node != nullptr)
+			_store->retireNode(defined.node);
+	}
 }
 
-void CppSystem::_init()
+void CppSystem::_init(char const* snapshot)
 {
 	/*
 	std::cerr << "CppSystem::_init:" << _static_entries->_entries.size() << std::endl;
@@ -154,6 +323,19 @@ void CppSystem::_init()
 
 	_store = new TypeStore();
 
+	// Symbols from the last boot with the same entries, initers will find rather than intern them
+	std::shared_ptr<Snapshot> image;
+	uint64_t print = 0;
+	if (snapshot != nullptr)
+	{
+		print = fingerprint();
+		image = Snapshot::open(snapshot);
+		if (image && image->fingerprint() == print)
+			image->seed(*_store);
+		else
+			image = nullptr;
+	}
+
 	// Set up graph and identifiers
 	_init_primeInternalEntries();
 	_init_insertEntries(_staticEntries, 0);
@@ -168,6 +350,19 @@ void CppSystem::_init()
 	*/
 
 	_update();
+
+	// The snapshot only speeds up the next boot, so failing to write it is not an error
+	if (snapshot != nullptr && (!image || image->symbolCount() != _store->s().count()))
+	{
+		try
+		{
+			Snapshot::write(snapshot, *_store, print);
+		}
+		catch (std::exception const& ex)
+		{
+			_addEntry({ new std::string(fmt::format("symbol snapshot `{0}` not written: {1}", snapshot, ex.what())), EntryKind::Warning });
+		}
+	}
 }
 
 bool CppSystem::_hasInited()
@@ -209,13 +404,25 @@ void CppSystem::_finish(char const* save, char const* name)
 	}
 
 	_addEntry({ new std::string(fmt::format("cpp-library-finish:{0}", name)), EntryKind::Marker });
+	_currentDllEntries->name = name;
+
+	auto existing = _dllNames.find(name);
+	if (existing != _dllNames.end())
+	{
+		// Loaded again, the new entries take the old one's place and replace it on update
+		_addEntry({ new std::string(fmt::format("cpp-library-reload:{0}", name)), EntryKind::Marker });
 
-	if (_dllNames.find(name) != _dllNames.end())
-		_addEntry({ new std::string("cpp-library-already-exists"), EntryKind::Warning });
-	
-	auto index = _dllEntries.size();
-	_dllEntries.push_back(_currentDllEntries);
-	_dllNames[name] = index;
+		auto old = _dllEntries[existing->second];
+		if (_dllsToReload.emplace(name, old).second == false)
+			delete old; // An earlier reload not updated yet, nothing of it is in the store
+
+		_dllEntries[existing->second] = _currentDllEntries;
+	}
+	else
+	{
+		_dllNames[name] = _dllEntries.size();
+		_dllEntries.push_back(_currentDllEntries);
+	}
 	_dllsToUpdate.insert(name);
 	_lastLoadedDll = name;
 	_currentDllEntries = nullptr;
@@ -224,8 +431,16 @@ void CppSystem::_finish(char const* save, char const* name)
 void CppSystem::_update()
 {
 	//std::cerr << "CppSystem::_update:" << _dll_entries[*_dllsToUpdate.begin()]->_entries.size() << std::endl;
+
+	// Reloads settle once all libraries are updated, see `TypeStore::Replacement`
+	TypeStore::Replacement replacement(*_store);
+
 	for (auto d : _dllsToUpdate)
 	{
+		auto reload = _dllsToReload.find(d);
+		if (reload != _dllsToReload.end())
+			_init_adoptEntries(reload->second, _dllEntries[_dllNames[d]]);
+
 		_init_insertEntries(_dllEntries[_dllNames[d]], 0);
 	}
 	for (auto d : _dllsToUpdate)
@@ -233,12 +448,48 @@ void CppSystem::_update()
 		_init_runEntries(_dllEntries[_dllNames[d]], 0);
 	}
 
+	for (auto const& reload : _dllsToReload)
+		delete reload.second;
+	_dllsToReload.clear();
 	_dllsToUpdate.clear();
 }
 
 void CppSystem::_clear()
 {
+	if (!_hasInited())
+		return;
+
+	// Retires every library loaded since boot, they can then be unloaded (or loaded anew)
+	TypeStore::Replacement replacement(*_store);
+
+	std::vector<std::string> names(_dllEntries.size());
+	for (auto const& named : _dllNames)
+		names[named.second] = named.first;
+
+	std::vector<_Entries*> kept;
+	_dllNames.clear();
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		if (_dllsThatWereStatic.count(names[i]) != 0)
+		{
+			_dllNames[names[i]] = kept.size();
+			kept.push_back(_dllEntries[i]);
+			continue;
+		}
+
+		_retireEntries(_dllEntries[i]);
+		delete _dllEntries[i];
+	}
+	for (auto const& reload : _dllsToReload)
+	{
+		_retireEntries(reload.second);
+		delete reload.second;
+	}
 
+	_dllEntries = std::move(kept);
+	_dllsToReload.clear();
+	_dllsToUpdate.clear();
+	_lastLoadedDll = "";
 }
 
 void CppSystem::_addEntry(_Entry && e)
@@ -256,6 +507,12 @@ void CppSystem::_addEntry(_Entry && e)
 
 	if (!_hasInited())
 		_staticEntries->entries.push_back(e);
+	else if (e.kind == EntryKind::Warning && _currentDllEntries == nullptr)
+	{
+		// Raised by the system itself outside of any library (e.g. by boot once the store exists)
+		_staticEntries->entries.push_back(e);
+		return;
+	}
 
 	if (_currentDllEntries == nullptr)
 	{
@@ -271,6 +528,90 @@ void CppSystem::_register(CppDefine const* info)
 	_addEntry({ const_cast<CppDefine*>(info), EntryKind::StaticDefine });
 }
 
+void CppSystem::setLazyInit(bool lazy)
+{
+	_lazyInit = lazy;
+}
+
+void CppSystem::setInitThreads(size_t threads)
+{
+	_initThreads = threads != 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+namespace
+{
+	// Where the binary `address` is in is loaded, and it's path.
+	uintptr_t module_of(void const* address, std::string& path)
+	{
+#ifdef _WIN32
+		HMODULE module = nullptr;
+		if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)address, &module))
+		{
+			char buffer[MAX_PATH];
+			path.assign(buffer, GetModuleFileNameA(module, buffer, MAX_PATH));
+			return (uintptr_t)module;
+		}
+#else
+		Dl_info info;
+		if (dladdr(address, &info) != 0 && info.dli_fname != nullptr)
+		{
+			path = info.dli_fname;
+			return (uintptr_t)info.dli_fbase;
+		}
+#endif
+		path.clear();
+		return 0;
+	}
+
+	// A binary's path, size and modification time, which change with every build of it.
+	std::string build_of(std::string const& path)
+	{
+		std::error_code size_ec, time_ec;
+		auto size = std::filesystem::file_size(path, size_ec);
+		auto time = std::filesystem::last_write_time(path, time_ec);
+		return fmt::format("{0}:{1}:{2}", path, size_ec ? 0 : size, time_ec ? 0 : time.time_since_epoch().count());
+	}
+}
+
+uint64_t CppSystem::fingerprint() const
+{
+	// Names are only known once initers run, so defines are identified by their offset into the
+	// binary they are in (which moves with any change to it's layout, but not with where it is
+	// loaded), and each binary by it's file
+	std::string desc;
+	auto describe = [&](_Entries const* entries)
+	{
+		desc += entries->name;
+
+		std::string path;
+		uintptr_t module = 0;
+		for (auto const& entry : entries->entries)
+		{
+			desc += fmt::format("|{0}", (int)entry.kind);
+			if (entry.kind == EntryKind::StaticDefine)
+			{
+				auto define = reinterpret_cast<CppDefine const*>(entry.ptr);
+				auto base = module_of(define, path);
+				if (base != module)
+				{
+					module = base;
+					desc += "@" + build_of(path);
+				}
+				desc += fmt::format(":{0}:{1}:{2:x}", (int)define->kind, define->initer != nullptr, (uintptr_t)define - base);
+			}
+			else
+				desc += ":" + *reinterpret_cast<std::string const*>(entry.ptr);
+		}
+		desc += "\n";
+	};
+
+	describe(_staticEntries);
+	for (auto entries : _dllEntries)
+		describe(entries);
+
+	return SymbolTable::hash(desc);
+}
+
 
 size_t CppSystem::getLibraryCount() const
 {
@@ -128,6 +128,36 @@ namespace syn
 		inline static TypeId id() { return desc().asId(); }
 		inline static Graph::Node const* graphNode() { return id(); }
 	};
+
+	namespace details
+	{
+		template<typename TType, typename Enable = void>
+		struct has_type_define : std::false_type { };
+
+		template<typename TType>
+		struct has_type_define<TType, std::void_t<decltype(sizeof(type_define<TType>))>> : std::true_type { };
+
+		template<typename TType>
+		struct cpp_dispatch_type_impl
+		{
+			inline static TypeId id()
+			{
+				if constexpr (has_type_define<TType>::value)
+					return type<TType>::id();
+				else
+					return None;
+			}
+		};
+
+		template<typename TType, template <typename> typename TPolicy>
+		struct cpp_dispatch_type_impl<instance<TType, TPolicy>>
+			: cpp_dispatch_type_impl<TType>
+		{ };
+
+		// The type a C++ argument of type `TType` is dispatched on, `None` when it could be anything.
+		template<typename TType>
+		using cpp_dispatch_type = cpp_dispatch_type_impl<std::remove_cv_t<std::remove_pointer_t<std::decay_t<TType>>>>;
+	}
 }
 
 #include "CppSystem.h"
@@ -142,11 +172,23 @@ namespace syn
 	{
 		return CppSystem::global_instance().types();
 	}
+	// The global store, unless this thread is in a `TypeStore::Scope` (e.g. of an overlay).
 	inline TypeStore& thread_store()
 	{
-		return CppSystem::global_instance().types();
+		auto store = TypeStore::Scope::current();
+		return store != nullptr ? *store : CppSystem::global_instance().types();
 	}
 
+// The `Symbol` for a string literal in the global store. The literal is hashed at compile time and
+// interned on first use, after which this is a load of a static.
+#define SYN_SYMBOL(literal) \
+	([]() -> ::syn::Symbol \
+	{ \
+		static constexpr ::syn::SymbolLiteral _literal(literal); \
+		static ::syn::Symbol const _symbol = ::syn::global_store().s().require(_literal); \
+		return _symbol; \
+	}())
+
 	inline CppDefine::CppDefine(CppDefineKind kind_, void* repr_, details::CppDefineRunner<> initer_)
 	{
 		initer = initer_;
@@ -213,7 +255,7 @@ namespace syn
 	// should always be static...
 	template <typename TDispatcher = void>
 	class Multimethod final
-		: CppDefine
+		: public CppDefine
 	{
 	private:
 		TDispatcher* _dispatch;
@@ -228,11 +270,23 @@ namespace syn
 			// TODO? use a friend to initalize this thing?
 		}
 
+		// Defined in `cpp/dispatch/Multimethod`, uses a per thread cache for each signature and
+		// multimethod (shared by every call site with both, see `CallSiteCaches`).
 		template<typename TReturn = void, typename... TArgs>
-		TReturn invoke(TArgs &&... args)
-		{
+		inline TReturn invoke(TArgs &&... args);
 
-		}
+		// Defined in `cpp/dispatch/Multimethod`, uses the given call site cache.
+		template<typename TReturn = void, size_t TSize, typename... TArgs>
+		inline TReturn invokeAt(CallSiteCache<sizeof...(TArgs), TSize>& site, TArgs &&... args);
+
+	private:
+		// Defined in `cpp/dispatch/Multimethod`, for arguments whose types are known statically.
+		template<typename TReturn, typename... TArgs>
+		inline TReturn _invokeStatic(TArgs &&... args);
+
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+		inline void _countCall(bool site_hit);
+#endif
 	};
 
 	/******************************************************************************
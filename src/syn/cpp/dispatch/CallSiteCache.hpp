@@ -0,0 +1,162 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** CallTarget
+	******************************************************************************/
+
+	/* A resolved C++ callable function, everything needed to call it without touching the graph.
+	*/
+
+	struct CallTarget final
+	{
+		TypeId function;
+		void (*fptr)();
+		instance<> (*call)(void (*)(), GenericInvoke&);
+
+		// Only set when the caller's static types are exactly the function's, see `fromFunction`.
+		void (*direct)(void (*)(), void*, void**);
+
+		// If `args` are given, `direct` is kept when the function is dispatched on exactly `args`
+		// and either the caller `discards` the result, or it returns exactly `returns` (which must
+		// be a type the function's result is known to be, `None` never matches).
+		inline static CallTarget fromFunction(TypeId function, TypeId const* args = nullptr, size_t count = 0, TypeId returns = None, bool discards = false)
+		{
+			auto node = (Graph::Node const*)function;
+			auto& store = thread_store();
+
+			auto generic = store.onlyPropOfTypeOnNode<core::PCppGenericCall>(node);
+			if (generic == nullptr)
+				throw stdext::exception("Function {0} can not be called from C++.", function);
+
+			CallTarget res = { function, GraphConfig::typed_load<core::NFunction>(node->data)->fptr, generic->call, nullptr };
+
+			if (args != nullptr && generic->direct != nullptr && (discards || (returns != None && returns == generic->returns)))
+			{
+				auto dispatch_args = store.onlyPropOfTypeOnNode<core::PDispatchArguments>(node);
+				if (dispatch_args != nullptr && dispatch_args->types.size() == count
+					&& std::equal(dispatch_args->types.begin(), dispatch_args->types.end(), args))
+					res.direct = generic->direct;
+			}
+
+			return res;
+		}
+	};
+
+	/******************************************************************************
+	** CallSiteCache
+	******************************************************************************/
+
+	/* An inline cache for C++ calls of multimethods.
+	 *
+	 * Holds up to `TSize` targets keyed by dispatcher and argument types: a single entry is
+	 * monomorphic, more are polymorphic. Once full the site is megamorphic and misses go to the
+	 * dispatcher's own table. Each entry is tagged with the `TypeStore::dispatchRevision` of it's
+	 * dispatcher, so a change to one dispatcher only drops that dispatcher's entries.
+	 *
+	 * `Multimethod::invoke` keeps them per thread by signature and dispatcher (see
+	 * `CallSiteCaches`), so calls of other multimethods never push a multimethod's targets out. A
+	 * call site holding it's own and calling `invokeAt` gets a cache for itself.
+	 */
+	template<size_t TArity, size_t TSize /* = 4 */>
+	class CallSiteCache final
+	{
+	private:
+		struct _Entry
+		{
+			TypeId dispatcher;
+			std::array<TypeId, TArity> args;
+			uint64_t revision;
+			CallTarget target;
+		};
+
+		size_t _count;
+		bool _megamorphic;
+		_Entry _entries[TSize];
+
+	public:
+		inline CallSiteCache()
+			: _count(0)
+			, _megamorphic(false)
+		{ }
+
+		inline size_t count() const { return _count; }
+		inline bool isMegamorphic() const { return _megamorphic; }
+
+		inline void clear()
+		{
+			_count = 0;
+			_megamorphic = false;
+		}
+
+		// The target for `args`, if it was resolved at the dispatcher's current `revision`.
+		inline CallTarget const* find(TypeId dispatcher, std::array<TypeId, TArity> const& args, uint64_t revision) const
+		{
+			for (size_t i = 0; i < _count; ++i)
+				if (_entries[i].dispatcher == dispatcher && _entries[i].args == args)
+					return _entries[i].revision == revision ? &_entries[i].target : nullptr;
+			return nullptr;
+		}
+
+		inline void insert(TypeId dispatcher, std::array<TypeId, TArity> const& args, uint64_t revision, CallTarget const& target)
+		{
+			// Entries of the dispatcher from an older revision are stale, make room by dropping them
+			size_t kept = 0;
+			for (size_t i = 0; i < _count; ++i)
+				if (_entries[i].dispatcher != dispatcher || _entries[i].revision == revision)
+					_entries[kept++] = _entries[i];
+			if (kept != _count)
+			{
+				_count = kept;
+				_megamorphic = false;
+			}
+
+			if (_count == TSize)
+			{
+				_megamorphic = true;
+				return;
+			}
+
+			_entries[_count++] = { dispatcher, args, revision, target };
+		}
+	};
+
+	/******************************************************************************
+	** CallSiteCaches
+	******************************************************************************/
+
+	/* A `CallSiteCache` per dispatcher, for calls of one signature.
+	 *
+	 * Dispatchers map onto `TCount` caches by pointer. A dispatcher taking a cache over from
+	 * another (which only happens when they collide) starts it empty, so it's targets and
+	 * megamorphic state never carry over to a different dispatcher.
+	 */
+	template<size_t TArity, size_t TCount = 16>
+	class CallSiteCaches final
+	{
+	private:
+		static_assert((TCount & (TCount - 1)) == 0, "TCount must be a power of two.");
+
+		struct _Slot
+		{
+			Graph::Node const* dispatcher = nullptr;
+			CallSiteCache<TArity> cache;
+		};
+
+		_Slot _slots[TCount];
+
+	public:
+		inline CallSiteCache<TArity>& of(Graph::Node const* dispatcher)
+		{
+			auto& slot = _slots[(size_t)(((uint64_t)(uintptr_t)dispatcher * 0x9e3779b97f4a7c15ull) >> 32) & (TCount - 1)];
+			if (slot.dispatcher != dispatcher)
+			{
+				slot.dispatcher = dispatcher;
+				slot.cache.clear();
+			}
+			return slot.cache;
+		}
+	};
+}
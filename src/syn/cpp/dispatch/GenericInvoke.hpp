@@ -8,23 +8,305 @@ namespace syn
 	******************************************************************************/
 
 	/* Helper structure for containing a generic call from the bootstrap implementation
-	*/
+	 *
+	 * Keeps up to `InlineCount` arguments inline and only spills to the heap for larger arities. A
+	 * borrowed invoke refers to the caller's arguments directly, without copying (or incref-ing)
+	 * them, and can not be grown.
+	 */
 
-	struct GenericInvoke
+	struct GenericInvoke final
 	{
-		std::vector<instance<>> args;
+	public:
+		static constexpr size_t InlineCount = 6;
+
+		struct BorrowTag { };
+		static constexpr BorrowTag Borrow = { };
+
+	private:
+		instance<>* _args;
+		size_t _count;
+		size_t _capacity;
+		bool _borrowed;
 
+		alignas(instance<>) std::byte _inline[InlineCount * sizeof(instance<>)];
+
+		inline void _grow(size_t capacity)
+		{
+			if (_borrowed)
+				throw stdext::exception("Can not grow a borrowed GenericInvoke.");
+			if (capacity <= _capacity)
+				return;
+
+			auto args = reinterpret_cast<instance<>*>(::operator new(capacity * sizeof(instance<>)));
+			for (size_t i = 0; i < _count; ++i)
+			{
+				new (args + i) instance<>(std::move(_args[i]));
+				_args[i].~instance<>();
+			}
+
+			if (_args != reinterpret_cast<instance<>*>(_inline))
+				::operator delete(_args);
+
+			_args = args;
+			_capacity = capacity;
+		}
+
+	public:
+		inline GenericInvoke()
+			: _args(reinterpret_cast<instance<>*>(_inline))
+			, _count(0)
+			, _capacity(InlineCount)
+			, _borrowed(false)
+		{ }
 		inline GenericInvoke(size_t presize)
+			: GenericInvoke()
 		{
-			args.reserve(presize);
+			_grow(presize);
 		}
 		inline GenericInvoke(instance<>* argv, size_t argc)
+			: GenericInvoke(argc)
 		{
-			args.insert(args.end(), argv, argv + argc);
+			for (size_t i = 0; i < argc; ++i)
+				push_back(argv[i]);
 		}
 		inline GenericInvoke(std::initializer_list<instance<>> l)
+			: GenericInvoke(l.size())
+		{
+			for (auto const& arg : l)
+				push_back(arg);
+		}
+		// Takes ownership of each argument without copying them.
+		template<typename... TArgs>
+		inline GenericInvoke(std::in_place_t, TArgs&&... args)
+			: GenericInvoke(sizeof...(TArgs))
+		{
+			(push_back(std::forward<TArgs>(args)), ...);
+		}
+		// Refers to the caller's arguments, which must outlive this.
+		inline GenericInvoke(BorrowTag, instance<>* argv, size_t argc)
+			: _args(argv)
+			, _count(argc)
+			, _capacity(argc)
+			, _borrowed(true)
+		{ }
+
+		inline ~GenericInvoke()
 		{
-			args.insert(args.end(), l.begin(), l.end());
+			if (_borrowed)
+				return;
+
+			for (size_t i = 0; i < _count; ++i)
+				_args[i].~instance<>();
+
+			if (_args != reinterpret_cast<instance<>*>(_inline))
+				::operator delete(_args);
+		}
+
+		GenericInvoke(GenericInvoke const&) = delete;
+		GenericInvoke& operator=(GenericInvoke const&) = delete;
+
+	public:
+		inline size_t size() const { return _count; }
+		inline bool isBorrowed() const { return _borrowed; }
+		inline bool isInline() const { return _args == reinterpret_cast<instance<> const*>(_inline); }
+
+		inline instance<>* data() { return _args; }
+		inline instance<>* begin() { return _args; }
+		inline instance<>* end() { return _args + _count; }
+		inline instance<> const* data() const { return _args; }
+		inline instance<> const* begin() const { return _args; }
+		inline instance<> const* end() const { return _args + _count; }
+
+		inline instance<>& operator[](size_t i) { return _args[i]; }
+		inline instance<> const& operator[](size_t i) const { return _args[i]; }
+
+		inline void push_back(instance<> const& arg)
+		{
+			if (_count == _capacity)
+				_grow(_capacity * 2);
+			new (_args + _count) instance<>(arg);
+			_count += 1;
+		}
+		inline void push_back(instance<>&& arg)
+		{
+			if (_count == _capacity)
+				_grow(_capacity * 2);
+			new (_args + _count) instance<>(std::move(arg));
+			_count += 1;
 		}
 	};
-}
\ No newline at end of file
+
+	/******************************************************************************
+	** Generic calls
+	******************************************************************************/
+
+	/* Converts between C++ function signatures and generic argument packs, these are the
+	   implementations behind `core::PCppGenericCall`.
+	*/
+
+	namespace details
+	{
+		template<typename TType>
+		struct cpp_generic_instance
+			: std::false_type
+		{ };
+
+		template<typename TType, template <typename> typename TPolicy>
+		struct cpp_generic_instance<instance<TType, TPolicy>>
+			: std::true_type
+		{
+			using type = TType;
+		};
+
+		// Whether a C++ value of type `TType` can be boxed into an instance: instances, values of
+		// defined types, and pointers to those (borrowed, see `cpp_generic_value::pack`).
+		template<typename TType>
+		struct cpp_packable
+		{
+			using Type = std::decay_t<TType>;
+			using Pointee = std::remove_cv_t<std::remove_pointer_t<Type>>;
+
+			static constexpr bool value = cpp_generic_instance<Type>::value
+				|| (std::is_pointer_v<Type> ? !std::is_pointer_v<Pointee> && has_type_define<Pointee>::value : has_type_define<Type>::value);
+		};
+
+		template<typename TType>
+		struct cpp_generic_value
+		{
+			// A C++ value (or instance) as an instance. A pointer is borrowed as an instance of it's
+			// pointee (null for a null pointer), it must outlive the result.
+			template<typename TValue>
+			inline static instance<> pack(TValue&& value)
+			{
+				using Type = std::decay_t<TValue>;
+				static_assert(cpp_packable<Type>::value, "Only instances, values of defined types and pointers to them can be passed generically.");
+
+				if constexpr (cpp_generic_instance<Type>::value)
+					return instance<>(value);
+				else if constexpr (std::is_pointer_v<Type>)
+				{
+					using Pointee = typename cpp_packable<Type>::Pointee;
+					if (value == nullptr)
+						return instance<>();
+					return instance<Pointee>::borrow(const_cast<Pointee*>(value));
+				}
+				else
+					return instance<Type>::make(std::forward<TValue>(value));
+			}
+
+			// A C++ argument as an instance for a call: an lvalue is borrowed, so the method sees (and
+			// may change) the caller's object as a direct call would, an rvalue is moved into it's own.
+			template<typename TValue>
+			inline static instance<> pass(TValue&& value)
+			{
+				using Type = std::decay_t<TValue>;
+				if constexpr (!cpp_generic_instance<Type>::value && has_type_define<Type>::value && std::is_lvalue_reference_v<TValue>)
+					return instance<Type>::borrow(const_cast<Type*>(std::addressof(value)));
+				else
+					return pack(std::forward<TValue>(value));
+			}
+
+			// An instance as the C++ parameter type `TType`, the type was checked by dispatch.
+			inline static TType unpack(instance<>& value)
+			{
+				using Type = std::remove_cv_t<std::remove_reference_t<TType>>;
+				if constexpr (std::is_same_v<Type, instance<>>)
+					return value;
+				else if constexpr (cpp_generic_instance<Type>::value)
+					return value.template cast<typename cpp_generic_instance<Type>::type>();
+				else if constexpr (std::is_pointer_v<Type>)
+					return reinterpret_cast<Type>(value.get());
+				else
+				{
+					if (value.isNull())
+						throw stdext::exception("Cannot pass a null instance as a value.");
+					return *reinterpret_cast<Type*>(value.get());
+				}
+			}
+		};
+
+		template<typename TType>
+		struct cpp_direct_value
+		{
+			using Type = std::remove_cv_t<std::remove_reference_t<TType>>;
+
+			static constexpr bool supported = !cpp_generic_instance<Type>::value;
+
+			inline static TType unpack(void* value)
+			{
+				if constexpr (std::is_pointer_v<Type>)
+					return reinterpret_cast<Type>(value);
+				else
+					return *reinterpret_cast<Type*>(value);
+			}
+		};
+
+		template<typename TReturn, typename... TArgs, size_t... TIndices>
+		inline void _cpp_direct_call(TReturn (*fn)(TArgs...), void* result, void** args, std::index_sequence<TIndices...>)
+		{
+			if constexpr (std::is_void_v<TReturn>)
+				fn(cpp_direct_value<TArgs>::unpack(args[TIndices])...);
+			else if (result == nullptr)
+				fn(cpp_direct_value<TArgs>::unpack(args[TIndices])...);
+			else
+				new (result) std::decay_t<TReturn>(fn(cpp_direct_value<TArgs>::unpack(args[TIndices])...));
+		}
+
+		// Calls `fptr` (which must have the signature `TReturn (*)(TArgs...)`) with pointers to it's arguments.
+		template<typename TReturn, typename... TArgs>
+		inline void cpp_direct_call(void (*fptr)(), void* result, void** args)
+		{
+			_cpp_direct_call(reinterpret_cast<TReturn (*)(TArgs...)>(fptr), result, args, std::index_sequence_for<TArgs...>());
+		}
+
+		// The type a direct call returning `TReturn` writes into it's result, `None` when it can't be
+		// told apart from others: no type define, or a pointer (which `type` sees through).
+		template<typename TReturn>
+		inline TypeId cpp_direct_return_type()
+		{
+			using Type = std::remove_cv_t<std::remove_reference_t<TReturn>>;
+			if constexpr (std::is_void_v<Type> || std::is_pointer_v<Type> || !has_type_define<Type>::value)
+				return None;
+			else
+				return type<Type>::id();
+		}
+
+		// The direct call for a signature, if it has one.
+		template<typename TReturn, typename... TArgs>
+		inline constexpr void (*cpp_direct_call_for())(void (*)(), void*, void**)
+		{
+			if constexpr ((cpp_direct_value<TArgs>::supported && ...) && cpp_direct_value<TReturn>::supported)
+				return &cpp_direct_call<TReturn, TArgs...>;
+			else
+				return nullptr;
+		}
+
+		template<typename TReturn, typename... TArgs, size_t... TIndices>
+		inline instance<> _cpp_generic_call(TReturn (*fn)(TArgs...), GenericInvoke& invoke, std::index_sequence<TIndices...>)
+		{
+			if constexpr (std::is_void_v<TReturn>)
+			{
+				fn(cpp_generic_value<TArgs>::unpack(invoke[TIndices])...);
+				return instance<>();
+			}
+			else if constexpr (!cpp_packable<TReturn>::value)
+			{
+				// Left null, `cpp_generic_return` throws for these
+				fn(cpp_generic_value<TArgs>::unpack(invoke[TIndices])...);
+				return instance<>();
+			}
+			else
+				return cpp_generic_value<TReturn>::pack(fn(cpp_generic_value<TArgs>::unpack(invoke[TIndices])...));
+		}
+
+		// Calls `fptr` (which must have the signature `TReturn (*)(TArgs...)`) with the generic arguments.
+		template<typename TReturn, typename... TArgs>
+		inline instance<> cpp_generic_call(void (*fptr)(), GenericInvoke& invoke)
+		{
+			if (invoke.size() != sizeof...(TArgs))
+				throw stdext::exception("Expected {0} arguments, was given {1}.", sizeof...(TArgs), invoke.size());
+
+			return _cpp_generic_call(reinterpret_cast<TReturn (*)(TArgs...)>(fptr), invoke, std::index_sequence_for<TArgs...>());
+		}
+	}
+}
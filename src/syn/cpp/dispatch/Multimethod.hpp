@@ -0,0 +1,181 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** Multimethod::invoke
+	******************************************************************************/
+
+	namespace details
+	{
+		template<typename TReturn>
+		inline TReturn cpp_generic_return(instance<>& value)
+		{
+			using Type = std::remove_cv_t<std::remove_reference_t<TReturn>>;
+			if constexpr (std::is_void_v<TReturn>)
+				return;
+			else if constexpr (cpp_generic_instance<Type>::value)
+				return cpp_generic_value<TReturn>::unpack(value);
+			else if constexpr (std::is_pointer_v<Type> || !has_type_define<Type>::value)
+				// Generic calls box results (see `cpp_generic_value::pack`), these never are, and a
+				// pointer's pointee is only borrowed by it's box
+				throw stdext::exception("A method's result can only be returned as a pointer, or a type without a type define, by a direct call.");
+			else
+			{
+				if (value.isNull())
+					throw stdext::exception("Method returned nothing, expected {0}.", type<Type>::id());
+				return *value.template cast<Type>();
+			}
+		}
+
+		// An argument of C++ type `TType` whose concrete type is it's static type.
+		template<typename TType>
+		struct cpp_static_argument
+		{
+			using Type = std::remove_cv_t<std::remove_reference_t<TType>>;
+
+			static constexpr bool value = !std::is_pointer_v<Type>
+				&& !cpp_generic_instance<Type>::value
+				&& (!std::is_polymorphic_v<Type> || std::is_final_v<Type>)
+				&& has_type_define<Type>::value;
+		};
+
+		template<typename... TArgs>
+		struct cpp_static_dispatch
+		{
+			static constexpr bool value = (cpp_static_argument<TArgs>::value && ...);
+		};
+	}
+
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+	template<typename TDispatcher>
+	inline void Multimethod<TDispatcher>::_countCall(bool site_hit)
+	{
+		auto index = dispatch_cache(node).statsIndex;
+		details::dispatch_stats_count(index, details::DispatchCounter::Calls);
+		if (site_hit)
+			details::dispatch_stats_count(index, details::DispatchCounter::SiteHits);
+	}
+#endif
+
+	template<typename TDispatcher>
+	template<typename TReturn, typename... TArgs>
+	inline TReturn Multimethod<TDispatcher>::invoke(TArgs &&... args)
+	{
+		if constexpr (sizeof...(TArgs) > 0 && details::cpp_static_dispatch<TArgs...>::value)
+			return _invokeStatic<TReturn>(std::forward<TArgs>(args)...);
+		else
+		{
+			// Per signature and dispatcher, call sites wanting their own should use `invokeAt`
+			static thread_local CallSiteCaches<sizeof...(TArgs)> __signature_caches;
+			return invokeAt<TReturn>(__signature_caches.of(node), std::forward<TArgs>(args)...);
+		}
+	}
+
+	/* The argument types are compile time constants here, so the dispatch key is too. The target is
+	   resolved once per signature (and dispatcher revision), and if the method takes exactly these types
+	   it is called through it's direct trampoline without boxing anything.
+	*/
+	template<typename TDispatcher>
+	template<typename TReturn, typename... TArgs>
+	inline TReturn Multimethod<TDispatcher>::_invokeStatic(TArgs &&... args)
+	{
+		using ReturnType = std::remove_cv_t<std::remove_reference_t<TReturn>>;
+
+		// Per signature and dispatcher, as in `invoke`
+		static thread_local CallSiteCaches<sizeof...(TArgs)> __signature_caches;
+		auto& __signature_cache = __signature_caches.of(node);
+
+		std::array<TypeId, sizeof...(TArgs)> types = { type<typename details::cpp_static_argument<TArgs>::Type>::id()... };
+
+		auto revision = thread_store().dispatchRevision(node);
+		auto target = __signature_cache.find(node, types, revision);
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+		_countCall(target != nullptr);
+#endif
+		CallTarget resolved;
+		if (target == nullptr)
+		{
+			// Targets picked by value are resolved on every call rather than cached.
+			bool by_value = value_dispatched(node, types.data(), types.size());
+			void const* values[] = { reinterpret_cast<void const*>(std::addressof(args))... };
+
+			auto function = basic_dispatch(node, types.data(), types.size(), by_value ? values : nullptr);
+			if (function == None)
+				throw stdext::exception("No method of {0} applies to the given arguments.", TypeId(node));
+
+			// A result whose type can't be checked against the function's is never written directly
+			resolved = CallTarget::fromFunction(function, types.data(), types.size(),
+				details::cpp_direct_return_type<TReturn>(), std::is_void_v<TReturn>);
+			if (!by_value)
+				__signature_cache.insert(node, types, revision, resolved);
+			target = &resolved;
+		}
+
+		if (target->direct != nullptr
+			&& (std::is_void_v<TReturn> || !details::cpp_generic_instance<ReturnType>::value))
+		{
+			void* argv[] = { const_cast<void*>(reinterpret_cast<void const*>(std::addressof(args)))... };
+
+			if constexpr (std::is_void_v<TReturn>)
+			{
+				target->direct(target->fptr, nullptr, argv);
+				return;
+			}
+			else if constexpr (!details::cpp_generic_instance<ReturnType>::value)
+			{
+				alignas(ReturnType) std::byte storage[sizeof(ReturnType)];
+				target->direct(target->fptr, storage, argv);
+
+				auto ptr = std::launder(reinterpret_cast<ReturnType*>(storage));
+				ReturnType res = std::move(*ptr);
+				ptr->~ReturnType();
+				return res;
+			}
+		}
+
+		// By reference, as the direct call above
+		GenericInvoke call(std::in_place, details::cpp_generic_value<TArgs>::pass(std::forward<TArgs>(args))...);
+		auto result = target->call(target->fptr, call);
+		return details::cpp_generic_return<TReturn>(result);
+	}
+
+	template<typename TDispatcher>
+	template<typename TReturn, size_t TSize, typename... TArgs>
+	inline TReturn Multimethod<TDispatcher>::invokeAt(CallSiteCache<sizeof...(TArgs), TSize>& site, TArgs &&... args)
+	{
+		GenericInvoke call(std::in_place, details::cpp_generic_value<TArgs>::pass(std::forward<TArgs>(args))...);
+
+		std::array<TypeId, sizeof...(TArgs)> types;
+		for (size_t i = 0; i < types.size(); ++i)
+			types[i] = call[i].isNull() ? None : call[i].typeId();
+
+		auto revision = thread_store().dispatchRevision(node);
+		auto target = site.find(node, types, revision);
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+		_countCall(target != nullptr);
+#endif
+		CallTarget resolved;
+		if (target == nullptr)
+		{
+			// Targets picked by value are resolved on every call rather than cached.
+			bool by_value = value_dispatched(node, types.data(), types.size());
+			std::array<void const*, sizeof...(TArgs)> values;
+			for (size_t i = 0; i < values.size(); ++i)
+				values[i] = call[i].isNull() ? nullptr : call[i].get();
+
+			auto function = basic_dispatch(node, types.data(), types.size(), by_value ? values.data() : nullptr);
+			if (function == None)
+				throw stdext::exception("No method of {0} applies to the given arguments.", TypeId(node));
+
+			resolved = CallTarget::fromFunction(function);
+			if (!by_value)
+				site.insert(node, types, revision, resolved);
+			target = &resolved;
+		}
+
+		auto result = target->call(target->fptr, call);
+		return details::cpp_generic_return<TReturn>(result);
+	}
+}
@@ -34,8 +34,8 @@ namespace types
 	inline IExpression* to_expression_tuple(GenericInvoke const& invoke)
 	{
 		std::vector<IExpression*> exprs;
-		exprs.reserve(invoke.args.size());
-		std::transform(invoke.args.begin(), invoke.args.end(), std::back_inserter(exprs),
+		exprs.reserve(invoke.size());
+		std::transform(invoke.begin(), invoke.end(), std::back_inserter(exprs),
 			[](instance<> inst) { return to_expression(inst.typeId()); });
 
 		return new ExpressionTuple(exprs);
@@ -135,13 +135,13 @@ namespace types
 		// varargs
 		if (tuple->varType != nullptr)
 		{
-			assert(t_size <= i.args.size());
+			assert(t_size <= i.size());
 
 			// TODO: improve
 			typedef VarArgs<instance<>> VarArgs;
 			VarArgs va;
-			va.args.reserve(i.args.size() - t_size);
-			std::copy(i.args.begin() + t_size, i.args.end(), std::back_inserter(va.args));
+			va.args.reserve(i.size() - t_size);
+			std::copy(i.begin() + t_size, i.end(), std::back_inserter(va.args));
 
 			// WITH ret
 			if (arrow->output != &ExpressionVoid::Value)
@@ -151,17 +151,17 @@ namespace types
 				case 0:
 					return reinterpret_cast<instance<>(*)(VarArgs)>(f)(va);
 				case 1:
-					return reinterpret_cast<instance<>(*)(instance<>, VarArgs)>(f)(i.args[0], va);
+					return reinterpret_cast<instance<>(*)(instance<>, VarArgs)>(f)(i[0], va);
 				case 2:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], va);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, VarArgs)>(f)(i[0], i[1], va);
 				case 3:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], va);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], va);
 				case 4:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], va);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], i[3], va);
 				case 5:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4], va);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], i[3], i[4], va);
 				case 6:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4], i.args[5], va);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], i[3], i[4], i[5], va);
 				default:
 					throw type_runtime_error("invoke not compiled for this.");
 				}
@@ -174,17 +174,17 @@ namespace types
 				case 0:
 					reinterpret_cast<void(*)(VarArgs)>(f)(va); break;
 				case 1:
-					reinterpret_cast<void(*)(instance<>, VarArgs)>(f)(i.args[0], va); break;
+					reinterpret_cast<void(*)(instance<>, VarArgs)>(f)(i[0], va); break;
 				case 2:
-					reinterpret_cast<void(*)(instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], va); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, VarArgs)>(f)(i[0], i[1], va); break;
 				case 3:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], va); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], va); break;
 				case 4:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], va); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], i[3], va); break;
 				case 5:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4], va); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], i[3], i[4], va); break;
 				case 6:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4], i.args[5], va); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>, VarArgs)>(f)(i[0], i[1], i[2], i[3], i[4], i[5], va); break;
 				default:
 					throw type_runtime_error("invoke not compiled for this.");
 				}
@@ -195,7 +195,7 @@ namespace types
 		// standard
 		else
 		{
-			assert(t_size == i.args.size());
+			assert(t_size == i.size());
 
 			// WITH ret
 			if (arrow->output != &ExpressionVoid::Value)
@@ -205,17 +205,17 @@ namespace types
 				case 0:
 					return reinterpret_cast<instance<>(*)()>(f)();
 				case 1:
-					return reinterpret_cast<instance<>(*)(instance<>)>(f)(i.args[0]);
+					return reinterpret_cast<instance<>(*)(instance<>)>(f)(i[0]);
 				case 2:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>)>(f)(i.args[0], i.args[1]);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>)>(f)(i[0], i[1]);
 				case 3:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2]);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2]);
 				case 4:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2], i.args[3]);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2], i[3]);
 				case 5:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4]);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2], i[3], i[4]);
 				case 6:
-					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4], i.args[5]);
+					return reinterpret_cast<instance<>(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2], i[3], i[4], i[5]);
 				default:
 					throw type_runtime_error("invoke not compiled for this.");
 				}
@@ -228,17 +228,17 @@ namespace types
 				case 0:
 					reinterpret_cast<void(*)()>(f)(); break;
 				case 1:
-					reinterpret_cast<void(*)(instance<>)>(f)(i.args[0]); break;
+					reinterpret_cast<void(*)(instance<>)>(f)(i[0]); break;
 				case 2:
-					reinterpret_cast<void(*)(instance<>, instance<>)>(f)(i.args[0], i.args[1]); break;
+					reinterpret_cast<void(*)(instance<>, instance<>)>(f)(i[0], i[1]); break;
 				case 3:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2]); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2]); break;
 				case 4:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2], i.args[3]); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2], i[3]); break;
 				case 5:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4]); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2], i[3], i[4]); break;
 				case 6:
-					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i.args[0], i.args[1], i.args[2], i.args[3], i.args[4], i.args[5]); break;
+					reinterpret_cast<void(*)(instance<>, instance<>, instance<>, instance<>, instance<>, instance<>)>(f)(i[0], i[1], i[2], i[3], i[4], i[5]); break;
 				default:
 					throw type_runtime_error("invoke not compiled for this.");
 				}
@@ -359,6 +359,17 @@ namespace syn
 							reinterpret_cast<void*>(&_deleterPtr)
 						)};
 				}
+
+				// Refers to `*ptr` without owning it, it must outlive every copy of the result.
+				inline static instance<TType> borrow(TType* ptr)
+				{
+					return {
+						new InstanceHeader(
+							reinterpret_cast<void*>(ptr),
+							(uintptr_t)syn::type<TType>::desc().asId(),
+							InstanceLifecycle::ReferenceCounted(0) | InstanceLifecycle::DeleterNoAction
+						)};
+				}
 			};
 		};
 
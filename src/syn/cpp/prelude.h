@@ -7,4 +7,10 @@ namespace syn
 	// Defined in `cpp/system`
 	class CppSystem;
 	inline CppSystem& system();
+
+	// Defined in `cpp/dispatch/GenericInvoke`
+	struct GenericInvoke;
+
+	// Defined in `cpp/dispatch/CallSiteCache`
+	template<size_t TArity, size_t TSize = 4> class CallSiteCache;
 }
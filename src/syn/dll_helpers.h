@@ -11,11 +11,19 @@ namespace dll {
 		system()._init();
 	}
 
+	// Boots with the symbols of a previous boot mapped from `snapshot`, writing it if missing or stale.
+	inline void boot(std::string const& snapshot)
+	{
+		system();
+		system()._init(snapshot.c_str());
+	}
+
 	inline void update()
 	{
 		system()._update();
 	}
 
+	// Retires the definitions of every library loaded since boot.
 	inline void reset()
 	{
 		system()._clear();
@@ -35,11 +43,61 @@ namespace dll {
 	{
 		auto target = std::filesystem::path(path).lexically_normal();
 #ifdef _WIN32
-		auto handle = LoadLibraryW(target.c_str());
+		void* handle = LoadLibraryW(target.c_str());
+		if (handle == nullptr) throw stdext::exception(stdext::platform::windows::GetLastErrorAsString());
+#else
+		void* handle = dlopen(path.c_str(), RTLD_NOW);
+		if (handle == nullptr) throw stdext::exception(dlerror());
+#endif
+		// Loaded already, keep one reference so `reload` unloads it with one close
+		if (!system()._dllHandles.emplace(target.string(), handle).second)
+		{
+#ifdef _WIN32
+			FreeLibrary((HMODULE)handle);
+#else
+			dlclose(handle);
+#endif
+		}
+		system()._update();
+	}
+
+	// Unloads the library at `path` and loads it again, replacing it's definitions in the store
+	// (see `CppSystem::_finish`). Nothing may run the library's code, or dispatch, meanwhile. Only
+	// libraries opened by `load` can be reloaded, the rest are never unloaded. Throws, keeping the
+	// library as it was, if closing it did not unload it (something else holds it open, or it can't
+	// be unloaded), since loading it again would then only hand back the same image.
+	inline void reload(std::string const& path)
+	{
+		auto target = std::filesystem::path(path).lexically_normal();
+		auto& handles = system()._dllHandles;
+		auto loaded = handles.find(target.string());
+		if (loaded == handles.end())
+			throw stdext::exception("Library `{0}` was not loaded with `dll::load`, it can not be reloaded.", target.string());
+
+		// Closes the only reference we hold, the one the load opened
+		auto handle = loaded->second;
+		handles.erase(loaded);
+#ifdef _WIN32
+		FreeLibrary((HMODULE)handle);
+		if (GetModuleHandleW(target.c_str()) != nullptr)
+		{
+			handles.emplace(target.string(), LoadLibraryW(target.c_str()));
+			throw stdext::exception("Library `{0}` stayed loaded after closing it, it can not be reloaded.", target.string());
+		}
+		handle = LoadLibraryW(target.c_str());
 		if (handle == nullptr) throw stdext::exception(stdext::platform::windows::GetLastErrorAsString());
 #else
-		if (!dlopen(path.c_str(), RTLD_NOW)) throw stdext::exception(dlerror());
+		dlclose(handle);
+		if (auto resident = dlopen(path.c_str(), RTLD_NOW | RTLD_NOLOAD))
+		{
+			// Takes the reference back
+			handles.emplace(target.string(), resident);
+			throw stdext::exception("Library `{0}` stayed loaded after closing it, it can not be reloaded.", target.string());
+		}
+		handle = dlopen(path.c_str(), RTLD_NOW);
+		if (handle == nullptr) throw stdext::exception(dlerror());
 #endif
+		handles.emplace(target.string(), handle);
 		system()._update();
 	}
 }}
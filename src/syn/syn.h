@@ -38,11 +38,24 @@
 #include "system/SymbolTable.h"
 
 /* Graph design (section 2.1) */
+#include "system/Epoch.h"
+#include "system/LockFreeIndex.h"
+#include "system/PayloadArena.h"
 #include "system/Graph.hpp"
+#include "system/SubtypeIndex.h"
+#include "system/FrozenGraph.h"
 
+#include "system/TypeOverlay.h"
 #include "system/TypeStore.h"
 #include "system/TypeId.h"
-
+#include "system/Snapshot.h"
+#include "system/Cached.h"
+#include "system/QueryPlan.h"
+
+#include "system/CompiledDispatch.h"
+#include "system/ValueDispatch.h"
+#include "system/DispatchCache.h"
+#include "system/DispatchStats.h"
 #include "system/dispatch.h"
 
 #include "system/ModuleBase.h"
@@ -90,7 +103,9 @@
 // dispatch ///////////////////////////////////////////////////////////////////
 
 #include "cpp/dispatch/GenericInvoke.hpp"
+#include "cpp/dispatch/CallSiteCache.hpp"
 #include "cpp/dispatch/BasicDispatcher.hpp"
+#include "cpp/dispatch/Multimethod.hpp"
 //#include "cpp/dispatch/SimpleDispatcher.hpp"
 
 /*
@@ -0,0 +1,64 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** Cached
+	******************************************************************************/
+
+	/* A value derived from a `TypeStore`, recomputed only when a revision it depends on moves.
+	 *
+	 * e.g. `Cached<size_t> methods({ store.typeRevision<core::EUsingDispatcherFunction>() });` and
+	 * later `methods.get([&]() { return count_methods(store); })`.
+	 *
+	 * The revisions are read before computing, so a change racing the computation leaves the
+	 * value stale rather than wrongly current. A `Cached` is not synchronized itself, keep one per
+	 * thread or guard it.
+	 */
+	template<typename T>
+	class Cached final
+	{
+	private:
+		struct _Dependency
+		{
+			TypeStore::Revision revision;
+			uint64_t seen;
+		};
+
+		std::vector<_Dependency> _dependencies;
+		std::optional<T> _value;
+
+	public:
+		inline Cached(std::initializer_list<TypeStore::Revision> dependencies)
+		{
+			for (auto r : dependencies)
+				_dependencies.push_back({ r, 0 });
+		}
+
+		// Whether a value was computed and none of it's dependencies moved since.
+		inline bool valid() const
+		{
+			if (!_value)
+				return false;
+			for (auto const& d : _dependencies)
+				if (d.revision.load() != d.seen)
+					return false;
+			return true;
+		}
+
+		inline void invalidate() { _value.reset(); }
+
+		template<typename TFunc>
+		inline T const& get(TFunc&& compute)
+		{
+			if (valid())
+				return *_value;
+
+			for (auto& d : _dependencies)
+				d.seen = d.revision.load();
+			_value.emplace(compute());
+			return *_value;
+		}
+	};
+}
@@ -0,0 +1,218 @@
+#include "syn/syn.h"
+#include "CompiledDispatch.h"
+
+using namespace syn;
+
+/******************************************************************************
+** CompiledDispatch
+******************************************************************************/
+
+CompiledDispatch::CompiledDispatch(uint64_t revision, std::vector<Method> const& methods, SubtypeIndex const& subtypes)
+	: _revision(revision)
+	, _arities()
+{
+	std::vector<std::vector<Method const*>> by_arity;
+	for (auto const& method : methods)
+	{
+		if (by_arity.size() <= method.types.size())
+			by_arity.resize(method.types.size() + 1);
+		by_arity[method.types.size()].push_back(&method);
+	}
+
+	_arities.resize(by_arity.size());
+	for (size_t count = 0; count < by_arity.size(); ++count)
+		if (!by_arity[count].empty())
+			_compileArity(_arities[count], count, by_arity[count], subtypes);
+}
+
+void CompiledDispatch::_compileArity(_Arity& arity, size_t count, std::vector<Method const*> const& methods, SubtypeIndex const& subtypes)
+{
+	arity.used = true;
+	arity.classes.resize(count);
+	arity.class_counts.resize(count);
+
+	// Per position, the specializers each class is-a, as flags indexed like `specializers[i]`
+	std::vector<std::vector<TypeId>> specializers(count);
+	std::vector<std::vector<std::vector<bool>>> class_specializers(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto& specs = specializers[i];
+		for (auto method : methods)
+			if (method->types[i] != None && std::find(specs.begin(), specs.end(), method->types[i]) == specs.end())
+				specs.push_back(method->types[i]);
+
+		// Every type that could match a specializer is one of them or a descendant
+		std::vector<Graph::Node const*> types;
+		for (auto spec : specs)
+		{
+			types.push_back(spec);
+			subtypes.forAllDescendants(spec, [&](Graph::Node const* n) { types.push_back(n); });
+		}
+
+		std::map<std::vector<bool>, uint32_t> signature_classes;
+		signature_classes[std::vector<bool>(specs.size(), false)] = 0;
+		class_specializers[i].push_back(std::vector<bool>(specs.size(), false));
+
+		for (auto t : types)
+		{
+			if (arity.classes[i].count(t))
+				continue;
+
+			std::vector<bool> signature(specs.size());
+			for (size_t s = 0; s < specs.size(); ++s)
+				signature[s] = t == (Graph::Node const*)specs[s] || subtypes.isA(t, specs[s]);
+
+			auto it = signature_classes.find(signature);
+			if (it == signature_classes.end())
+			{
+				it = signature_classes.emplace(signature, (uint32_t)class_specializers[i].size()).first;
+				class_specializers[i].push_back(signature);
+			}
+			if (it->second != 0)
+				arity.classes[i].emplace(t, it->second);
+		}
+
+		arity.class_counts[i] = (uint32_t)class_specializers[i].size();
+	}
+
+	// Resolve every combination of classes, row by row
+	size_t row_count = 1;
+	for (size_t i = 0; i + 1 < count; ++i)
+		row_count *= arity.class_counts[i];
+	size_t column_count = count == 0 ? 1 : arity.class_counts[count - 1];
+
+	std::vector<uint32_t> combo(count, 0);
+	std::vector<std::vector<TypeId>> distinct_rows;
+	std::map<std::vector<TypeId>, uint32_t> row_indices;
+	arity.rows.resize(row_count);
+
+	for (size_t r = 0; r < row_count; ++r)
+	{
+		std::vector<TypeId> row(column_count, None);
+		for (size_t c = 0; c < column_count; ++c)
+		{
+			if (count > 0)
+				combo[count - 1] = (uint32_t)c;
+
+			std::vector<Method const*> applicable;
+			for (auto method : methods)
+			{
+				bool applies = true;
+				for (size_t i = 0; i < count && applies; ++i)
+				{
+					auto spec = method->types[i];
+					if (spec == None) continue;
+					auto s = std::find(specializers[i].begin(), specializers[i].end(), spec) - specializers[i].begin();
+					applies = class_specializers[i][combo[i]][s];
+				}
+				if (applies)
+					applicable.push_back(method);
+			}
+
+			for (auto candidate : applicable)
+			{
+				bool best = true;
+				for (auto other : applicable)
+				{
+					if (other == candidate) continue;
+					if (!more_specific(candidate->types, other->types) || more_specific(other->types, candidate->types))
+					{
+						best = false;
+						break;
+					}
+				}
+				if (best)
+				{
+					row[c] = candidate->function;
+					break;
+				}
+			}
+		}
+
+		auto it = row_indices.find(row);
+		if (it == row_indices.end())
+		{
+			it = row_indices.emplace(row, (uint32_t)distinct_rows.size()).first;
+			distinct_rows.push_back(row);
+		}
+		arity.rows[r] = it->second;
+
+		// Advance the row part of the combination (all but the last argument)
+		for (size_t i = count > 0 ? count - 1 : 0; i-- > 0; )
+		{
+			if (++combo[i] < arity.class_counts[i]) break;
+			combo[i] = 0;
+		}
+	}
+
+	// Row displacement, densest rows first
+	std::vector<uint32_t> order(distinct_rows.size());
+	for (uint32_t u = 0; u < order.size(); ++u) order[u] = u;
+	auto filled = [&](uint32_t u) { return std::count_if(distinct_rows[u].begin(), distinct_rows[u].end(), [](TypeId t) { return t != None; }); };
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return filled(a) > filled(b); });
+
+	arity.offsets.resize(distinct_rows.size(), 0);
+	for (auto u : order)
+	{
+		auto const& row = distinct_rows[u];
+		if (filled(u) == 0)
+			continue;
+
+		uint32_t offset = 0;
+		for (;; ++offset)
+		{
+			bool fits = true;
+			for (size_t c = 0; c < row.size() && fits; ++c)
+				fits = row[c] == None || offset + c >= arity.check.size() || arity.check[offset + c] == _Empty;
+			if (fits) break;
+		}
+
+		if (arity.check.size() < offset + row.size())
+		{
+			arity.check.resize(offset + row.size(), _Empty);
+			arity.values.resize(offset + row.size(), None);
+		}
+		for (size_t c = 0; c < row.size(); ++c)
+		{
+			if (row[c] == None) continue;
+			arity.check[offset + c] = u;
+			arity.values[offset + c] = row[c];
+		}
+		arity.offsets[u] = offset;
+	}
+}
+
+size_t CompiledDispatch::size() const
+{
+	size_t res = 0;
+	for (auto const& arity : _arities)
+		res += arity.values.size();
+	return res;
+}
+
+TypeId CompiledDispatch::lookup(TypeId const* type_args, size_t count) const
+{
+	if (count >= _arities.size() || !_arities[count].used)
+		return None;
+	auto const& arity = _arities[count];
+
+	size_t row = 0, column = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto const& classes = arity.classes[i];
+		auto it = classes.find(type_args[i]);
+		uint32_t c = it == classes.end() ? 0 : it->second;
+
+		if (i + 1 < count)
+			row = row * arity.class_counts[i] + c;
+		else
+			column = c;
+	}
+
+	auto u = arity.rows[row];
+	auto slot = arity.offsets[u] + column;
+	return slot < arity.check.size() && arity.check[slot] == u
+		? arity.values[slot]
+		: None;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** CompiledDispatch
+	******************************************************************************/
+
+	/* A precomputed dispatch table for every argument type combination of a dispatcher.
+	 *
+	 * For each arity and argument position the types are grouped into equivalence classes: types
+	 * that are-a the same subset of the specializers used at that position always select the same
+	 * method. Types related to no specializer share the fallback class 0. The table over all class
+	 * combinations is then compressed by row displacement: rows are the combined classes of all
+	 * but the last argument, identical rows are shared, and each distinct row is placed at an
+	 * offset into one flat array where it's non empty cells don't collide with any other row.
+	 *
+	 * A lookup is a hash probe per argument and one array read, regardless of how many types or
+	 * methods exist. Tables are immutable and tagged with the dispatcher revision they were built at.
+	 */
+	class CompiledDispatch final
+	{
+	public:
+		struct Method
+		{
+			TypeId function;
+			std::vector<TypeId> types;
+		};
+
+	private:
+		static constexpr uint32_t _Empty = ~uint32_t(0);
+
+		struct _Arity
+		{
+			bool used = false;
+
+			// Per argument position, type to class (`0` when missing)
+			std::vector<std::unordered_map<Graph::Node const*, uint32_t>> classes;
+			std::vector<uint32_t> class_counts;
+
+			// Row (flattened classes of all but the last argument) to distinct row
+			std::vector<uint32_t> rows;
+			// Distinct row to displacement in `check`/`values`
+			std::vector<uint32_t> offsets;
+			// Slot to the distinct row owning it, or `_Empty`
+			std::vector<uint32_t> check;
+			std::vector<TypeId> values;
+		};
+
+		uint64_t _revision;
+		std::vector<_Arity> _arities;
+
+		static void _compileArity(_Arity& arity, size_t count, std::vector<Method const*> const& methods, SubtypeIndex const& subtypes);
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED CompiledDispatch(uint64_t revision, std::vector<Method> const& methods, SubtypeIndex const& subtypes);
+
+		inline uint64_t revision() const { return _revision; }
+
+		// Number of cells in the compressed tables, across all arities.
+		CULTLANG_SYNDICATE_EXPORTED size_t size() const;
+
+		CULTLANG_SYNDICATE_EXPORTED TypeId lookup(TypeId const* type_args, size_t count) const;
+	};
+}
@@ -0,0 +1,183 @@
+#include "syn/syn.h"
+#include "DispatchCache.h"
+
+using namespace syn;
+
+/******************************************************************************
+** DispatchCache
+******************************************************************************/
+
+DispatchCache::DispatchCache()
+	: _table(_makeTable(0, 8, 8))
+	, _compiled(nullptr)
+	, _values(nullptr)
+{ }
+
+DispatchCache::~DispatchCache()
+{
+	delete _table.load();
+	delete _compiled.load();
+	delete _values.load();
+}
+
+DispatchCache::_Table* DispatchCache::_makeTable(uint64_t revision, size_t capacity, size_t args_capacity)
+{
+	auto table = new _Table();
+	table->revision = revision;
+	table->capacity = capacity;
+	table->slots.reset(new _Slot[capacity]);
+	for (size_t i = 0; i < capacity; ++i)
+		table->slots[i].arity.store(_EmptySlot, std::memory_order_relaxed);
+	table->argsCapacity = args_capacity;
+	table->args.reset(new TypeId[args_capacity]);
+	table->count.store(0, std::memory_order_relaxed);
+	table->argsCount = 0;
+	return table;
+}
+
+void DispatchCache::_place(_Table* table, size_t hash, TypeId const* type_args, size_t count, TypeId result)
+{
+	auto mask = table->capacity - 1;
+	auto i = hash & mask;
+	while (table->slots[i].arity.load(std::memory_order_relaxed) != _EmptySlot)
+		i = (i + 1) & mask;
+
+	auto& slot = table->slots[i];
+	slot.hash = hash;
+	slot.offset = (uint32_t)table->argsCount;
+	slot.result = result;
+	std::copy(type_args, type_args + count, table->args.get() + table->argsCount);
+	table->argsCount += count;
+
+	// Readers may already be probing this table, they only look at a slot once it's arity is set
+	slot.arity.store((uint32_t)count, std::memory_order_release);
+	table->count.fetch_add(1, std::memory_order_release);
+}
+
+void DispatchCache::_publish(_Table* table)
+{
+	auto old = _table.exchange(table, std::memory_order_acq_rel);
+	Epoch::retire(old);
+}
+
+uint64_t DispatchCache::revision() const
+{
+	Epoch::Guard guard;
+	return _table.load(std::memory_order_acquire)->revision;
+}
+
+size_t DispatchCache::count() const
+{
+	Epoch::Guard guard;
+	return _table.load(std::memory_order_acquire)->count.load(std::memory_order_acquire);
+}
+
+void DispatchCache::clear(uint64_t revision)
+{
+	std::lock_guard<std::mutex> lock(_write);
+	_publish(_makeTable(revision, 8, 8));
+}
+
+size_t DispatchCache::hash(TypeId const* type_args, size_t count)
+{
+	size_t res = count;
+	for (size_t i = 0; i < count; ++i)
+		res ^= std::hash<uintptr_t>()((uintptr_t)type_args[i]) + 0x9e3779b9 + (res << 6) + (res >> 2);
+	return res;
+}
+
+bool DispatchCache::find(uint64_t revision, TypeId const* type_args, size_t count, TypeId& result) const
+{
+	Epoch::Guard guard;
+	auto table = _table.load(std::memory_order_acquire);
+	if (table->revision != revision)
+		return false;
+
+	auto h = hash(type_args, count);
+	auto mask = table->capacity - 1;
+	for (auto i = h & mask; ; i = (i + 1) & mask)
+	{
+		auto const& slot = table->slots[i];
+		auto arity = slot.arity.load(std::memory_order_acquire);
+		if (arity == _EmptySlot)
+			return false;
+		if (slot.hash == h && arity == count
+			&& std::equal(type_args, type_args + count, table->args.get() + slot.offset))
+		{
+			result = slot.result;
+			return true;
+		}
+	}
+}
+
+void DispatchCache::insert(uint64_t revision, TypeId const* type_args, size_t count, TypeId result)
+{
+	std::lock_guard<std::mutex> lock(_write);
+	auto current = _table.load(std::memory_order_relaxed);
+
+	// Results resolved against an old revision are stale, a newer one makes the table stale.
+	if (revision < current->revision)
+		return;
+	if (revision > current->revision)
+	{
+		auto table = _makeTable(revision, 8, std::max<size_t>(8, count));
+		_place(table, hash(type_args, count), type_args, count, result);
+		_publish(table);
+		return;
+	}
+
+	// Another writer may have beaten us to it.
+	TypeId existing;
+	if (find(revision, type_args, count, existing))
+		return;
+
+	// Keep the load factor at or below a half, appending in place while there is room.
+	auto entries = current->count.load(std::memory_order_relaxed);
+	if ((entries + 1) * 2 <= current->capacity && current->argsCount + count <= current->argsCapacity)
+	{
+		_place(current, hash(type_args, count), type_args, count, result);
+		return;
+	}
+
+	auto capacity = current->capacity;
+	while ((entries + 1) * 2 > capacity)
+		capacity *= 2;
+	auto args_capacity = std::max(current->argsCapacity * 2, current->argsCount + count);
+
+	auto table = _makeTable(revision, capacity, args_capacity);
+	for (size_t i = 0; i < current->capacity; ++i)
+	{
+		auto const& slot = current->slots[i];
+		auto arity = slot.arity.load(std::memory_order_relaxed);
+		if (arity != _EmptySlot)
+			_place(table, slot.hash, current->args.get() + slot.offset, arity, slot.result);
+	}
+	_place(table, hash(type_args, count), type_args, count, result);
+
+	_publish(table);
+}
+
+void DispatchCache::setCompiled(CompiledDispatch const* compiled)
+{
+	auto old = _compiled.exchange(compiled, std::memory_order_acq_rel);
+	if (old != nullptr)
+		Epoch::retire(const_cast<CompiledDispatch*>(old));
+}
+
+bool DispatchCache::findCompiled(uint64_t revision, TypeId const* type_args, size_t count, TypeId& result) const
+{
+	Epoch::Guard guard;
+	auto compiled = _compiled.load(std::memory_order_acquire);
+	if (compiled == nullptr || compiled->revision() != revision)
+		return false;
+
+	result = compiled->lookup(type_args, count);
+	return true;
+}
+
+void DispatchCache::setValues(ValueDispatch const* values)
+{
+	auto old = _values.exchange(values, std::memory_order_acq_rel);
+	if (old != nullptr)
+		Epoch::retire(const_cast<ValueDispatch*>(old));
+}
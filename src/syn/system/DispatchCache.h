@@ -0,0 +1,97 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** DispatchCache
+	******************************************************************************/
+
+	/* Memoizes dispatch results by argument type tuple, stored in `NDispatcher::dispatcher_state`.
+	 *
+	 * Readers never lock: the entries live in an open addressed table which is read under an
+	 * `Epoch::Guard`. Writers serialize on a mutex. A slot is filled once and published by
+	 * storing it's arity last, so while the table has room an insert only appends to it; when
+	 * it doesn't the writer copies it into one twice the size, publishes that with an atomic
+	 * swap and retires the old one (so inserts cost amortized constant time). Each table is
+	 * tagged with the dispatcher's revision (`TypeStore::dispatchRevision`) it was filled
+	 * against; a lookup against any other revision misses, and an insert for a newer revision
+	 * starts a fresh table.
+	 *
+	 * A dispatcher may also be compiled into a `CompiledDispatch`, published the same way, which
+	 * answers every lookup until the revision changes. The dispatcher's `ValueDispatch` tables are
+	 * kept here too.
+	 */
+	class DispatchCache final
+	{
+	private:
+		struct _Slot
+		{
+			size_t hash;
+			uint32_t offset;
+			// `_EmptySlot` until the rest of the slot (and it's arguments) are written
+			std::atomic<uint32_t> arity;
+			TypeId result;
+		};
+
+		struct _Table
+		{
+			uint64_t revision;
+			size_t capacity;
+			std::unique_ptr<_Slot[]> slots;
+			size_t argsCapacity;
+			std::unique_ptr<TypeId[]> args;
+
+			// Only changed by writers, under `_write`
+			std::atomic<size_t> count;
+			size_t argsCount;
+		};
+
+		static constexpr uint32_t _EmptySlot = ~uint32_t(0);
+
+		std::atomic<_Table*> _table;
+		std::atomic<CompiledDispatch const*> _compiled;
+		std::atomic<ValueDispatch const*> _values;
+		std::mutex _write;
+
+		static _Table* _makeTable(uint64_t revision, size_t capacity, size_t args_capacity);
+		static void _place(_Table* table, size_t hash, TypeId const* type_args, size_t count, TypeId result);
+
+		void _publish(_Table* table);
+
+	public:
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+		// See `DispatchStats`, assigned before the cache is published.
+		uint32_t statsIndex = 0;
+#endif
+
+		CULTLANG_SYNDICATE_EXPORTED DispatchCache();
+		CULTLANG_SYNDICATE_EXPORTED ~DispatchCache();
+
+		DispatchCache(DispatchCache const&) = delete;
+		DispatchCache& operator=(DispatchCache const&) = delete;
+
+		CULTLANG_SYNDICATE_EXPORTED uint64_t revision() const;
+		CULTLANG_SYNDICATE_EXPORTED size_t count() const;
+
+		CULTLANG_SYNDICATE_EXPORTED void clear(uint64_t revision);
+
+		CULTLANG_SYNDICATE_EXPORTED bool find(uint64_t revision, TypeId const* type_args, size_t count, TypeId& result) const;
+		CULTLANG_SYNDICATE_EXPORTED void insert(uint64_t revision, TypeId const* type_args, size_t count, TypeId result);
+
+		// Takes ownership of `compiled`, replacing any previous one.
+		CULTLANG_SYNDICATE_EXPORTED void setCompiled(CompiledDispatch const* compiled);
+		CULTLANG_SYNDICATE_EXPORTED bool findCompiled(uint64_t revision, TypeId const* type_args, size_t count, TypeId& result) const;
+
+		// The current value tables, only valid while the caller holds an `Epoch::Guard`.
+		inline ValueDispatch const* values() const { return _values.load(std::memory_order_acquire); }
+		// Takes ownership of `values`, replacing any previous one.
+		CULTLANG_SYNDICATE_EXPORTED void setValues(ValueDispatch const* values);
+
+		CULTLANG_SYNDICATE_EXPORTED static size_t hash(TypeId const* type_args, size_t count);
+
+		// Where `dispatcher`'s cache is kept, in it's packed `NDispatcher::dispatcher_state`. The
+		// store owning the node deletes it with the node's graph.
+		inline static std::atomic<DispatchCache*>& on(Graph::Node const* dispatcher);
+	};
+}
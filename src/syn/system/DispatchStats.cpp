@@ -0,0 +1,274 @@
+#include "syn/syn.h"
+#include "DispatchStats.h"
+
+using namespace syn;
+
+/******************************************************************************
+** DispatchStats
+******************************************************************************/
+
+uint64_t DispatchStats::latencyPercentile(double p) const
+{
+	uint64_t total = 0;
+	for (auto n : latency) total += n;
+	if (total == 0)
+		return 0;
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < LatencyBuckets; ++i)
+	{
+		seen += latency[i];
+		if (seen >= p * total)
+			return uint64_t(1) << (i + 1);
+	}
+	return uint64_t(1) << LatencyBuckets;
+}
+
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+
+using details::DispatchCounter;
+
+namespace
+{
+	constexpr size_t _PageSize = 64;
+	constexpr size_t _PageCount = 1024;
+
+	// Written only by the owning thread (relaxed load and store, never a contended RMW), read by anyone.
+	struct _Counters
+	{
+		std::atomic<uint64_t> counts[(size_t)DispatchCounter::Count];
+		std::atomic<uint64_t> latency[DispatchStats::LatencyBuckets];
+	};
+
+	struct _Page
+	{
+		_Counters counters[_PageSize];
+	};
+
+	struct _Dispatcher
+	{
+		TypeId dispatcher;
+		std::unordered_set<size_t> tuples;
+		// Totals of exited threads, and what to subtract since the last reset
+		DispatchStats retired;
+		DispatchStats baseline;
+	};
+
+	struct _ThreadCounters;
+
+	std::mutex _mutex;
+	std::vector<_Dispatcher> _dispatchers;
+	std::vector<_ThreadCounters*> _threads;
+
+	inline void _bump(std::atomic<uint64_t>& counter)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	void _add(DispatchStats& stats, _Counters const& c)
+	{
+		stats.calls += c.counts[(size_t)DispatchCounter::Calls].load(std::memory_order_relaxed);
+		stats.site_hits += c.counts[(size_t)DispatchCounter::SiteHits].load(std::memory_order_relaxed);
+		stats.dispatches += c.counts[(size_t)DispatchCounter::Dispatches].load(std::memory_order_relaxed);
+		stats.cache_hits += c.counts[(size_t)DispatchCounter::CacheHits].load(std::memory_order_relaxed);
+		stats.cache_misses += c.counts[(size_t)DispatchCounter::CacheMisses].load(std::memory_order_relaxed);
+		for (size_t i = 0; i < DispatchStats::LatencyBuckets; ++i)
+			stats.latency[i] += c.latency[i].load(std::memory_order_relaxed);
+	}
+
+	struct _ThreadCounters
+	{
+		std::array<std::atomic<_Page*>, _PageCount> pages;
+
+		_ThreadCounters()
+		{
+			for (auto& page : pages)
+				page.store(nullptr, std::memory_order_relaxed);
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_threads.push_back(this);
+		}
+
+		~_ThreadCounters()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_threads.erase(std::find(_threads.begin(), _threads.end(), this));
+
+			for (size_t p = 0; p < _PageCount; ++p)
+			{
+				auto page = pages[p].load(std::memory_order_relaxed);
+				if (page == nullptr)
+					continue;
+
+				for (size_t i = 0; i < _PageSize && p * _PageSize + i < _dispatchers.size(); ++i)
+					_add(_dispatchers[p * _PageSize + i].retired, page->counters[i]);
+				delete page;
+			}
+		}
+
+		_Counters* counters(uint32_t index)
+		{
+			auto p = index / _PageSize;
+			if (p >= _PageCount)
+				return nullptr;
+
+			auto page = pages[p].load(std::memory_order_relaxed);
+			if (page == nullptr)
+			{
+				page = new _Page();
+				for (auto& c : page->counters)
+				{
+					for (auto& n : c.counts) n.store(0, std::memory_order_relaxed);
+					for (auto& n : c.latency) n.store(0, std::memory_order_relaxed);
+				}
+				pages[p].store(page, std::memory_order_release);
+			}
+			return &page->counters[index % _PageSize];
+		}
+	};
+
+	_ThreadCounters& _thread_counters()
+	{
+		static thread_local _ThreadCounters counters;
+		return counters;
+	}
+
+	// Must hold `_mutex`.
+	DispatchStats _collect(uint32_t index)
+	{
+		auto const& dispatcher = _dispatchers[index];
+		DispatchStats res = dispatcher.retired;
+		for (auto thread : _threads)
+		{
+			auto page = thread->pages[index / _PageSize].load(std::memory_order_acquire);
+			if (page != nullptr)
+				_add(res, page->counters[index % _PageSize]);
+		}
+		res.distinct_tuples = dispatcher.tuples.size();
+		return res;
+	}
+
+	DispatchStats _since(DispatchStats stats, DispatchStats const& baseline)
+	{
+		stats.calls -= baseline.calls;
+		stats.site_hits -= baseline.site_hits;
+		stats.dispatches -= baseline.dispatches;
+		stats.cache_hits -= baseline.cache_hits;
+		stats.cache_misses -= baseline.cache_misses;
+		for (size_t i = 0; i < DispatchStats::LatencyBuckets; ++i)
+			stats.latency[i] -= baseline.latency[i];
+		return stats;
+	}
+
+	void _merge(DispatchStats& into, DispatchStats const& from)
+	{
+		into.calls += from.calls;
+		into.site_hits += from.site_hits;
+		into.dispatches += from.dispatches;
+		into.cache_hits += from.cache_hits;
+		into.cache_misses += from.cache_misses;
+		into.distinct_tuples = std::max(into.distinct_tuples, from.distinct_tuples);
+		for (size_t i = 0; i < DispatchStats::LatencyBuckets; ++i)
+			into.latency[i] += from.latency[i];
+	}
+}
+
+bool syn::dispatch_stats_enabled()
+{
+	return true;
+}
+
+uint32_t syn::details::dispatch_stats_register(TypeId dispatcher)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_dispatchers.push_back({ dispatcher, { }, { }, { } });
+	return (uint32_t)(_dispatchers.size() - 1);
+}
+
+void syn::details::dispatch_stats_count(uint32_t index, DispatchCounter counter)
+{
+	auto c = _thread_counters().counters(index);
+	if (c != nullptr)
+		_bump(c->counts[(size_t)counter]);
+}
+
+void syn::details::dispatch_stats_latency(uint32_t index, uint64_t nanoseconds)
+{
+	auto c = _thread_counters().counters(index);
+	if (c == nullptr)
+		return;
+
+	size_t bucket = 0;
+	while (nanoseconds > 1 && bucket + 1 < DispatchStats::LatencyBuckets)
+	{
+		nanoseconds >>= 1;
+		bucket += 1;
+	}
+	_bump(c->latency[bucket]);
+}
+
+void syn::details::dispatch_stats_tuple(uint32_t index, TypeId const* type_args, size_t count)
+{
+	auto hash = DispatchCache::hash(type_args, count);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_dispatchers[index].tuples.insert(hash);
+}
+
+DispatchStats syn::dispatch_stats(TypeId dispatcher)
+{
+	DispatchStats res;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (uint32_t i = 0; i < _dispatchers.size(); ++i)
+		if (_dispatchers[i].dispatcher == dispatcher)
+			_merge(res, _since(_collect(i), _dispatchers[i].baseline));
+	return res;
+}
+
+void syn::forAllDispatchStats(std::function<void(TypeId, DispatchStats const&)> const& f)
+{
+	std::vector<std::pair<TypeId, DispatchStats>> all;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (uint32_t i = 0; i < _dispatchers.size(); ++i)
+		{
+			auto stats = _since(_collect(i), _dispatchers[i].baseline);
+			auto it = std::find_if(all.begin(), all.end(), [&](auto const& e) { return e.first == _dispatchers[i].dispatcher; });
+			if (it == all.end())
+				all.push_back({ _dispatchers[i].dispatcher, stats });
+			else
+				_merge(it->second, stats);
+		}
+	}
+
+	for (auto const& e : all)
+		f(e.first, e.second);
+}
+
+void syn::reset_dispatch_stats()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (uint32_t i = 0; i < _dispatchers.size(); ++i)
+		_dispatchers[i].baseline = _collect(i);
+}
+
+#else
+
+bool syn::dispatch_stats_enabled()
+{
+	return false;
+}
+
+DispatchStats syn::dispatch_stats(TypeId dispatcher)
+{
+	return DispatchStats();
+}
+
+void syn::forAllDispatchStats(std::function<void(TypeId, DispatchStats const&)> const& f)
+{ }
+
+void syn::reset_dispatch_stats()
+{ }
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** DispatchStats
+	******************************************************************************/
+
+	/* Dispatch instrumentation, compiled in only with `CULTLANG_SYNDICATE_DISPATCH_STATS` defined
+	 * (bazel: `--define syn_dispatch_stats=on`). Without it nothing is counted and these all report
+	 * zeros. Counters are kept per thread and only summed when read.
+	 */
+	struct DispatchStats final
+	{
+		// Bucket `i` counts dispatches taking [2^i, 2^(i+1)) nanoseconds (bucket 0 includes 0).
+		static constexpr size_t LatencyBuckets = 32;
+
+		// `Multimethod::invoke` calls, and those answered by their call site cache.
+		uint64_t calls = 0;
+		uint64_t site_hits = 0;
+
+		// `basic_dispatch` calls, and whether they were answered without walking the graph.
+		uint64_t dispatches = 0;
+		uint64_t cache_hits = 0;
+		uint64_t cache_misses = 0;
+
+		// Argument type tuples `basic_dispatch` has resolved.
+		uint64_t distinct_tuples = 0;
+
+		std::array<uint64_t, LatencyBuckets> latency = { };
+
+		// The smallest bucket bound at or above fraction `p` of the dispatches, in nanoseconds.
+		CULTLANG_SYNDICATE_EXPORTED uint64_t latencyPercentile(double p) const;
+	};
+
+	CULTLANG_SYNDICATE_EXPORTED bool dispatch_stats_enabled();
+
+	CULTLANG_SYNDICATE_EXPORTED DispatchStats dispatch_stats(TypeId dispatcher);
+	CULTLANG_SYNDICATE_EXPORTED void forAllDispatchStats(std::function<void(TypeId, DispatchStats const&)> const& f);
+
+	// Starts counting from zero again (distinct tuples are kept).
+	CULTLANG_SYNDICATE_EXPORTED void reset_dispatch_stats();
+
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+	namespace details
+	{
+		enum class DispatchCounter
+		{
+			Calls,
+			SiteHits,
+			Dispatches,
+			CacheHits,
+			CacheMisses,
+
+			Count
+		};
+
+		CULTLANG_SYNDICATE_EXPORTED uint32_t dispatch_stats_register(TypeId dispatcher);
+
+		CULTLANG_SYNDICATE_EXPORTED void dispatch_stats_count(uint32_t index, DispatchCounter counter);
+		CULTLANG_SYNDICATE_EXPORTED void dispatch_stats_latency(uint32_t index, uint64_t nanoseconds);
+		CULTLANG_SYNDICATE_EXPORTED void dispatch_stats_tuple(uint32_t index, TypeId const* type_args, size_t count);
+	}
+#endif
+}
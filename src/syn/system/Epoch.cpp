@@ -0,0 +1,133 @@
+#include "syn/syn.h"
+#include "Epoch.h"
+
+using namespace syn;
+
+/******************************************************************************
+** Epoch
+******************************************************************************/
+
+namespace
+{
+	// A reader thread's announcement, 0 when outside of any guard. Records are never freed, a
+	// thread releases it's record on exit for a later thread to claim.
+	struct _Record
+	{
+		std::atomic<uint64_t> epoch;
+		std::atomic<bool> claimed;
+		_Record* next;
+		size_t depth;
+	};
+
+	struct _Retired
+	{
+		void* ptr;
+		void (*deleter)(void*);
+		uint64_t epoch;
+	};
+
+	// Starts at 1 so that 0 means "not reading".
+	std::atomic<uint64_t> _global_epoch { 1 };
+	std::atomic<_Record*> _records { nullptr };
+
+	std::mutex _retired_mutex;
+	std::vector<_Retired> _retired;
+
+	_Record* _claim_record()
+	{
+		for (auto r = _records.load(std::memory_order_acquire); r != nullptr; r = r->next)
+		{
+			bool expected = false;
+			if (!r->claimed.load(std::memory_order_relaxed) && r->claimed.compare_exchange_strong(expected, true))
+				return r;
+		}
+
+		auto r = new _Record();
+		r->epoch.store(0, std::memory_order_relaxed);
+		r->claimed.store(true, std::memory_order_relaxed);
+		r->depth = 0;
+		r->next = _records.load(std::memory_order_relaxed);
+		while (!_records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed))
+		{ }
+		return r;
+	}
+
+	struct _ThreadRecord
+	{
+		_Record* record = _claim_record();
+
+		~_ThreadRecord()
+		{
+			record->epoch.store(0, std::memory_order_release);
+			record->claimed.store(false, std::memory_order_release);
+		}
+	};
+
+	_Record* _thread_record()
+	{
+		static thread_local _ThreadRecord thread_record;
+		return thread_record.record;
+	}
+
+	// The oldest epoch a reader might still be using, anything retired before it is unreachable.
+	uint64_t _oldest_epoch()
+	{
+		uint64_t res = _global_epoch.load();
+		for (auto r = _records.load(std::memory_order_acquire); r != nullptr; r = r->next)
+		{
+			auto e = r->epoch.load();
+			if (e != 0 && e < res)
+				res = e;
+		}
+		return res;
+	}
+
+	size_t _collect_locked()
+	{
+		auto oldest = _oldest_epoch();
+
+		auto it = std::partition(_retired.begin(), _retired.end(),
+			[oldest](_Retired const& r) { return r.epoch >= oldest; });
+		for (auto i = it; i != _retired.end(); ++i)
+			i->deleter(i->ptr);
+		_retired.erase(it, _retired.end());
+
+		return _retired.size();
+	}
+}
+
+Epoch::Guard::Guard()
+{
+	auto r = _thread_record();
+	_record = r;
+
+	if (r->depth++ == 0)
+	{
+		r->epoch.store(_global_epoch.load());
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+}
+
+Epoch::Guard::~Guard()
+{
+	auto r = reinterpret_cast<_Record*>(_record);
+
+	if (--r->depth == 0)
+		r->epoch.store(0, std::memory_order_release);
+}
+
+void Epoch::retire(void* ptr, void (*deleter)(void*))
+{
+	// Readers entering after the bump load the replacement, so only older epochs can see `ptr`.
+	auto epoch = _global_epoch.fetch_add(1);
+
+	std::lock_guard<std::mutex> lock(_retired_mutex);
+	_retired.push_back({ ptr, deleter, epoch });
+	_collect_locked();
+}
+
+size_t Epoch::collect()
+{
+	std::lock_guard<std::mutex> lock(_retired_mutex);
+	return _collect_locked();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** Epoch
+	******************************************************************************/
+
+	/* Epoch based reclamation for data shared with lock free readers.
+	 *
+	 * Readers hold a `Epoch::Guard` while they use anything loaded from a shared pointer. Writers
+	 * swap the pointer first and then `retire` the old value, which is only deleted once every
+	 * reader that might still see it has left it's guard. Guards never block, and nest.
+	 */
+	class Epoch final
+	{
+	public:
+		struct Guard final
+		{
+		private:
+			void* _record;
+
+		public:
+			CULTLANG_SYNDICATE_EXPORTED Guard();
+			CULTLANG_SYNDICATE_EXPORTED ~Guard();
+
+			Guard(Guard const&) = delete;
+			Guard& operator=(Guard const&) = delete;
+		};
+
+		// Deletes `ptr` with `deleter` once no guard entered before this call is still held.
+		CULTLANG_SYNDICATE_EXPORTED static void retire(void* ptr, void (*deleter)(void*));
+
+		template<typename T>
+		inline static void retire(T* ptr)
+		{
+			retire(ptr, [](void* p) { delete reinterpret_cast<T*>(p); });
+		}
+
+		// Deletes whatever retired values are no longer reachable, returns how many are still pending.
+		CULTLANG_SYNDICATE_EXPORTED static size_t collect();
+	};
+}
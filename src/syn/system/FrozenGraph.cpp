@@ -0,0 +1,59 @@
+#include "syn/syn.h"
+#include "FrozenGraph.h"
+
+using namespace syn;
+
+using Node = Graph::Node;
+
+/******************************************************************************
+** FrozenGraph
+******************************************************************************/
+
+FrozenGraph::FrozenGraph(Graph& graph, SubtypeIndex const& subtypes, uint64_t revision)
+	: _revision(revision)
+{
+	std::vector<Node const*> nodes;
+	graph.forAllNodes([&](Node const* n) { nodes.push_back(n); });
+
+	size_t size = 16;
+	while (size < nodes.size() * 2)
+		size *= 2;
+	_slots.assign(size, _Slot { nullptr, npos, npos });
+
+	auto mask = size - 1;
+	for (uint32_t index = 0; index < nodes.size(); ++index)
+	{
+		auto node = nodes[index];
+		auto i = (size_t)(((uint64_t)(uintptr_t)node * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+		while (_slots[i].node != nullptr)
+			i = (i + 1) & mask;
+		_slots[i] = { node, index, subtypes.indexOf(node) };
+	}
+
+	// Stable, so the graph's order is kept within a type
+	auto by_type = [](auto const& a, auto const& b) { return std::less<void const*>()(a.type, b.type); };
+
+	_edgeOffsets.reserve(nodes.size() + 1);
+	_propOffsets.reserve(nodes.size() + 1);
+	for (auto node : nodes)
+	{
+		_edgeOffsets.push_back((uint32_t)_edges.size());
+		graph.forAllEdgesOnNode(node, [&](auto e) { _edges.push_back({ e->type.node, e }); });
+		std::stable_sort(_edges.begin() + _edgeOffsets.back(), _edges.end(), by_type);
+
+		_propOffsets.push_back((uint32_t)_props.size());
+		graph.forAllPropsOnNode(node, [&](auto p) { _props.push_back({ p->type.node, p }); });
+		std::stable_sort(_props.begin() + _propOffsets.back(), _props.end(), by_type);
+	}
+	_edgeOffsets.push_back((uint32_t)_edges.size());
+	_propOffsets.push_back((uint32_t)_props.size());
+
+	_ancestorOffsets.reserve(subtypes.count() + 1);
+	for (uint32_t i = 0; i < subtypes.count(); ++i)
+	{
+		_ancestorOffsets.push_back((uint32_t)_ancestors.size());
+		auto const& ancestors = subtypes.ancestors(i);
+		_ancestors.insert(_ancestors.end(), ancestors.begin(), ancestors.end());
+	}
+	_ancestorOffsets.push_back((uint32_t)_ancestors.size());
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** FrozenGraph
+	******************************************************************************/
+
+	/* A read only copy of a graph's adjacency, laid out for traversal (see `TypeStore::freeze`).
+	 *
+	 * Every node gets a dense index through one open addressed table. The edges on each node are
+	 * a contiguous range of one array (compressed sparse rows), sorted by edge type so the edges
+	 * of one type are a sub range, and likewise for props. The subtype closure is copied beside
+	 * it, so `isA` is a probe of the same table and a bit test. It is only valid at the revision
+	 * it was built at.
+	 */
+	class FrozenGraph final
+	{
+	public:
+		static constexpr uint32_t npos = ~uint32_t(0);
+
+	private:
+		struct _Slot
+		{
+			Graph::Node const* node;
+			uint32_t index;
+			// In the subtype closure, or `npos`
+			uint32_t subtype;
+		};
+
+		struct _Edge
+		{
+			void const* type;
+			Graph::Edge const* edge;
+		};
+
+		struct _Prop
+		{
+			void const* type;
+			Graph::Prop const* prop;
+		};
+
+		uint64_t _revision;
+
+		// A power of two in size, at most half full
+		std::vector<_Slot> _slots;
+
+		// `_edgeOffsets[i]` to `_edgeOffsets[i + 1]` are node `i`'s, and the same for props
+		std::vector<uint32_t> _edgeOffsets;
+		std::vector<_Edge> _edges;
+		std::vector<uint32_t> _propOffsets;
+		std::vector<_Prop> _props;
+
+		std::vector<uint32_t> _ancestorOffsets;
+		std::vector<uint64_t> _ancestors;
+
+		inline _Slot const* _find(Graph::Node const* node) const
+		{
+			auto mask = _slots.size() - 1;
+			auto i = (size_t)(((uint64_t)(uintptr_t)node * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+			for (; _slots[i].node != nullptr; i = (i + 1) & mask)
+				if (_slots[i].node == node)
+					return &_slots[i];
+			return nullptr;
+		}
+
+		// The first element from `begin` to `end` with a type not below `type`.
+		template<typename TElement>
+		inline static TElement const* _lowerBound(TElement const* begin, TElement const* end, void const* type)
+		{
+			return std::lower_bound(begin, end, type, [](TElement const& e, void const* t) { return std::less<void const*>()(e.type, t); });
+		}
+
+	public:
+		// Copies `graph` and `subtypes`, which must not change meanwhile.
+		CULTLANG_SYNDICATE_EXPORTED FrozenGraph(Graph& graph, SubtypeIndex const& subtypes, uint64_t revision);
+
+		inline uint64_t revision() const { return _revision; }
+		inline size_t nodeCount() const { return _edgeOffsets.size() - 1; }
+		inline size_t edgeCount() const { return _edges.size(); }
+
+		inline bool contains(Graph::Node const* node) const { return _find(node) != nullptr; }
+
+		// Every edge on `node`, grouped by type.
+		template<typename F>
+		inline void forAllEdgesOnNode(Graph::Node const* node, F const& f) const
+		{
+			auto slot = _find(node);
+			if (slot == nullptr)
+				return;
+
+			for (auto i = _edgeOffsets[slot->index], end = _edgeOffsets[slot->index + 1]; i < end; ++i)
+				f(_edges[i].edge);
+		}
+
+		// Every edge of type `type` on `node`, without looking at the others.
+		template<typename F>
+		inline void forAllEdgesOfTypeOnNode(Graph::Node const* node, void const* type, F const& f) const
+		{
+			auto slot = _find(node);
+			if (slot == nullptr)
+				return;
+
+			auto end = _edges.data() + _edgeOffsets[slot->index + 1];
+			for (auto e = _lowerBound(_edges.data() + _edgeOffsets[slot->index], end, type); e != end && e->type == type; ++e)
+				f(e->edge);
+		}
+
+		// Every prop on `node`, grouped by type (in the order they were added within one).
+		template<typename F>
+		inline void forAllPropsOnNode(Graph::Node const* node, F const& f) const
+		{
+			auto slot = _find(node);
+			if (slot == nullptr)
+				return;
+
+			for (auto i = _propOffsets[slot->index], end = _propOffsets[slot->index + 1]; i < end; ++i)
+				f(_props[i].prop);
+		}
+
+		inline bool isA(Graph::Node const* sub, Graph::Node const* super) const
+		{
+			auto sub_slot = _find(sub);
+			if (sub_slot == nullptr || sub_slot->subtype == npos) return false;
+			auto super_slot = _find(super);
+			if (super_slot == nullptr || super_slot->subtype == npos) return false;
+
+			auto begin = _ancestorOffsets[sub_slot->subtype];
+			auto word = super_slot->subtype >> 6;
+			return begin + word < _ancestorOffsets[sub_slot->subtype + 1]
+				&& (_ancestors[begin + word] & (uint64_t(1) << (super_slot->subtype & 63))) != 0;
+		}
+	};
+}
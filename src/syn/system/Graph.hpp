@@ -91,6 +91,9 @@ namespace syn
 		}
 		else
 		{
+			// Boxed in the arena of the store changing the graph, see `PayloadArena`
+			if (auto arena = PayloadArena::current())
+				return (void*) arena->make<T>(t);
 			return (void*) new T(t);
 		}
 	}
@@ -0,0 +1,242 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** LockFreeList
+	******************************************************************************/
+
+	/* An append only array read without locks, for the indexes a `TypeStore` keeps.
+	 *
+	 * Writers serialize among themselves (the store's write lock). An element is written past
+	 * the end and published by storing the new size, so while the block has room an append is
+	 * a store and a release. When it doesn't the writer copies it into one twice the size,
+	 * publishes that with an atomic swap and retires the old one through `Epoch`. Readers hold
+	 * a guard for as long as they read.
+	 */
+	template<typename T>
+	class LockFreeList final
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "LockFreeList elements are copied when it grows.");
+
+	private:
+		struct _Block
+		{
+			size_t capacity;
+			std::atomic<size_t> size;
+			std::unique_ptr<T[]> items;
+		};
+
+		std::atomic<_Block*> _block;
+
+		inline static _Block* _makeBlock(size_t capacity)
+		{
+			auto block = new _Block();
+			block->capacity = capacity;
+			block->size.store(0, std::memory_order_relaxed);
+			block->items.reset(new T[capacity]);
+			return block;
+		}
+
+		inline void _publish(_Block* block)
+		{
+			auto previous = _block.exchange(block, std::memory_order_acq_rel);
+			if (previous != nullptr)
+				Epoch::retire(previous);
+		}
+
+	public:
+		inline LockFreeList() : _block(nullptr) { }
+		inline ~LockFreeList() { delete _block.load(std::memory_order_acquire); }
+
+		LockFreeList(LockFreeList const&) = delete;
+		LockFreeList& operator=(LockFreeList const&) = delete;
+
+		inline size_t size() const
+		{
+			auto block = _block.load(std::memory_order_acquire);
+			return block != nullptr ? block->size.load(std::memory_order_acquire) : 0;
+		}
+
+		// Writers only.
+		inline void push_back(T const& item)
+		{
+			auto block = _block.load(std::memory_order_relaxed);
+			auto size = block != nullptr ? block->size.load(std::memory_order_relaxed) : 0;
+			if (block == nullptr || size == block->capacity)
+			{
+				auto grown = _makeBlock(block != nullptr ? block->capacity * 2 : 4);
+				if (size != 0)
+					std::copy(block->items.get(), block->items.get() + size, grown->items.get());
+				grown->items[size] = item;
+				grown->size.store(size + 1, std::memory_order_relaxed);
+				_publish(grown);
+				return;
+			}
+
+			block->items[size] = item;
+			block->size.store(size + 1, std::memory_order_release);
+		}
+
+		// Writers only, readers meanwhile see all of the elements or only those kept.
+		template<typename F>
+		inline void removeIf(F const& f)
+		{
+			auto block = _block.load(std::memory_order_relaxed);
+			if (block == nullptr)
+				return;
+
+			auto size = block->size.load(std::memory_order_relaxed);
+			auto kept = _makeBlock(block->capacity);
+			size_t count = 0;
+			for (size_t i = 0; i < size; ++i)
+				if (!f(block->items[i]))
+					kept->items[count++] = block->items[i];
+			kept->size.store(count, std::memory_order_relaxed);
+			_publish(kept);
+		}
+
+		// By index, `f` may append more while it runs (and sees them). Hold an `Epoch::Guard`.
+		template<typename F>
+		inline void forEach(F const& f) const
+		{
+			for (size_t i = 0; ; ++i)
+			{
+				auto block = _block.load(std::memory_order_acquire);
+				if (block == nullptr || i >= block->size.load(std::memory_order_acquire))
+					return;
+				f(block->items[i]);
+			}
+		}
+	};
+
+	/******************************************************************************
+	** LockFreeMap
+	******************************************************************************/
+
+	/* An insert only hash map read without locks, as `LockFreeList`.
+	 *
+	 * Each entry is allocated once and never moves or goes away before the map does, so what
+	 * `find` returns stays valid without a guard. The table of entry pointers is open addressed
+	 * and at most half full; an entry is published by storing it's pointer into a slot, growing
+	 * copies the pointers into a table twice the size and retires the old one. Values read
+	 * concurrently should be atomics or themselves lock free (e.g. a `LockFreeList`).
+	 */
+	template<typename TKey, typename TValue, typename THash = std::hash<TKey>>
+	class LockFreeMap final
+	{
+	private:
+		struct _Entry
+		{
+			TKey key;
+			TValue value;
+
+			inline _Entry(TKey const& key) : key(key), value() { }
+		};
+
+		struct _Table
+		{
+			size_t mask;
+			std::unique_ptr<std::atomic<_Entry*>[]> slots;
+		};
+
+		std::atomic<_Table*> _table;
+		// Only changed by writers
+		size_t _count;
+
+		inline static _Table* _makeTable(size_t capacity)
+		{
+			auto table = new _Table();
+			table->mask = capacity - 1;
+			table->slots.reset(new std::atomic<_Entry*>[capacity]);
+			for (size_t i = 0; i < capacity; ++i)
+				table->slots[i].store(nullptr, std::memory_order_relaxed);
+			return table;
+		}
+
+		inline static size_t _home(_Table const* table, TKey const& key)
+		{
+			return (size_t)((uint64_t)THash()(key) * 0x9e3779b97f4a7c15ull >> 32) & table->mask;
+		}
+
+		inline static _Entry* _find(_Table const* table, TKey const& key)
+		{
+			for (auto i = _home(table, key); ; i = (i + 1) & table->mask)
+			{
+				auto entry = table->slots[i].load(std::memory_order_acquire);
+				if (entry == nullptr || entry->key == key)
+					return entry;
+			}
+		}
+
+		inline static void _place(_Table* table, _Entry* entry)
+		{
+			auto i = _home(table, entry->key);
+			while (table->slots[i].load(std::memory_order_relaxed) != nullptr)
+				i = (i + 1) & table->mask;
+			table->slots[i].store(entry, std::memory_order_release);
+		}
+
+	public:
+		inline LockFreeMap() : _table(_makeTable(16)), _count(0) { }
+		inline ~LockFreeMap()
+		{
+			auto table = _table.load(std::memory_order_acquire);
+			for (size_t i = 0; i <= table->mask; ++i)
+				delete table->slots[i].load(std::memory_order_relaxed);
+			delete table;
+		}
+
+		LockFreeMap(LockFreeMap const&) = delete;
+		LockFreeMap& operator=(LockFreeMap const&) = delete;
+
+		// Writers only.
+		inline size_t size() const { return _count; }
+
+		// The value of `key`, or null. Hold an `Epoch::Guard` while it probes, the value outlives it.
+		inline TValue* find(TKey const& key) const
+		{
+			auto entry = _find(_table.load(std::memory_order_acquire), key);
+			return entry != nullptr ? &entry->value : nullptr;
+		}
+
+		// The value of `key`. If it had none one is value initialized, passed to `init` and then
+		// published. Writers only.
+		template<typename F>
+		inline TValue& require(TKey const& key, F const& init)
+		{
+			auto table = _table.load(std::memory_order_relaxed);
+			if (auto entry = _find(table, key))
+				return entry->value;
+
+			if ((_count + 1) * 2 > table->mask + 1)
+			{
+				auto grown = _makeTable((table->mask + 1) * 2);
+				for (size_t i = 0; i <= table->mask; ++i)
+					if (auto moved = table->slots[i].load(std::memory_order_relaxed))
+						_place(grown, moved);
+				_table.store(grown, std::memory_order_release);
+				Epoch::retire(table);
+				table = grown;
+			}
+
+			auto entry = new _Entry(key);
+			init(entry->value);
+			_place(table, entry);
+			_count += 1;
+			return entry->value;
+		}
+		inline TValue& require(TKey const& key) { return require(key, [](TValue&) { }); }
+
+		// Every entry, writers only.
+		template<typename F>
+		inline void forEach(F const& f) const
+		{
+			auto table = _table.load(std::memory_order_relaxed);
+			for (size_t i = 0; i <= table->mask; ++i)
+				if (auto entry = table->slots[i].load(std::memory_order_relaxed))
+					f(entry->key, entry->value);
+		}
+	};
+}
@@ -0,0 +1,67 @@
+#include "syn/syn.h"
+#include "PayloadArena.h"
+
+using namespace syn;
+
+/******************************************************************************
+** PayloadArena
+******************************************************************************/
+
+namespace
+{
+	thread_local PayloadArena* current_arena = nullptr;
+}
+
+PayloadArena::PayloadArena()
+	: _count(0)
+{ }
+
+PayloadArena::~PayloadArena()
+{
+	for (auto& it : _pools)
+	{
+		auto& pool = it.second;
+		for (size_t i = 0; i < pool.blocks.size(); ++i)
+		{
+			auto last = i + 1 == pool.blocks.size();
+			pool.destroy(pool.blocks[i], last ? pool.used : pool.perBlock);
+			::operator delete(pool.blocks[i], std::align_val_t(pool.align));
+		}
+	}
+}
+
+void* PayloadArena::_allocate(_Pool& pool)
+{
+	if (pool.used == pool.perBlock)
+	{
+		pool.blocks.push_back(::operator new(pool.size * pool.perBlock, std::align_val_t(pool.align)));
+		pool.used = 0;
+	}
+
+	_count += 1;
+	return reinterpret_cast<char*>(pool.blocks.back()) + pool.size * pool.used++;
+}
+
+size_t PayloadArena::bytes() const
+{
+	size_t res = 0;
+	for (auto const& it : _pools)
+		res += it.second.blocks.size() * it.second.size * it.second.perBlock;
+	return res;
+}
+
+PayloadArena* PayloadArena::current()
+{
+	return current_arena;
+}
+
+PayloadArena::Scope::Scope(PayloadArena& arena)
+	: _previous(current_arena)
+{
+	current_arena = &arena;
+}
+
+PayloadArena::Scope::~Scope()
+{
+	current_arena = _previous;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** PayloadArena
+	******************************************************************************/
+
+	/* Storage for graph payloads too large to pack into a pointer (see `GraphConfig::typed_store`).
+	 *
+	 * Payloads are kept in blocks holding only one type each, so scans over many nodes of a type
+	 * touch contiguous memory, and are destroyed along with the arena. A `TypeStore` owns one and
+	 * makes it `current` while it changes the graph, payloads stored with no current arena are
+	 * boxed on the heap (and never freed) as before. Not synchronized, like the graph itself.
+	 */
+	class PayloadArena final
+	{
+	private:
+		static constexpr size_t _BlockSize = 16 * 1024;
+
+		struct _Pool
+		{
+			size_t size;
+			size_t align;
+			size_t perBlock;
+			void (*destroy)(void* block, size_t count);
+
+			std::vector<void*> blocks;
+			size_t used;
+		};
+
+		// Keyed by a per type tag, see `_tag`
+		std::unordered_map<void const*, _Pool> _pools;
+		size_t _count;
+
+		template<typename T>
+		inline static void const* _tag() { static char tag; return &tag; }
+
+		CULTLANG_SYNDICATE_EXPORTED void* _allocate(_Pool& pool);
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED PayloadArena();
+		CULTLANG_SYNDICATE_EXPORTED ~PayloadArena();
+
+		PayloadArena(PayloadArena const&) = delete;
+		PayloadArena& operator=(PayloadArena const&) = delete;
+
+		template<typename T>
+		inline T* make(T const& value)
+		{
+			auto it = _pools.find(_tag<T>());
+			if (it == _pools.end())
+			{
+				_Pool pool;
+				pool.size = sizeof(T);
+				pool.align = alignof(T);
+				pool.perBlock = std::max<size_t>(8, _BlockSize / sizeof(T));
+				pool.destroy = [](void* block, size_t count)
+				{
+					for (size_t i = 0; i < count; ++i)
+						reinterpret_cast<T*>(block)[i].~T();
+				};
+				pool.used = pool.perBlock;
+				it = _pools.emplace(_tag<T>(), std::move(pool)).first;
+			}
+
+			auto& pool = it->second;
+			auto slot = _allocate(pool);
+			try
+			{
+				return new (slot) T(value);
+			}
+			catch (...)
+			{
+				pool.used -= 1;
+				_count -= 1;
+				throw;
+			}
+		}
+
+		// How many payloads are stored.
+		inline size_t count() const { return _count; }
+		// How many bytes of blocks are held.
+		CULTLANG_SYNDICATE_EXPORTED size_t bytes() const;
+
+		// The arena payloads are being stored into on this thread, if any.
+		CULTLANG_SYNDICATE_EXPORTED static PayloadArena* current();
+
+		// Makes an arena current on this thread for it's lifetime.
+		class Scope final
+		{
+		private:
+			PayloadArena* _previous;
+
+		public:
+			CULTLANG_SYNDICATE_EXPORTED Scope(PayloadArena& arena);
+			CULTLANG_SYNDICATE_EXPORTED ~Scope();
+
+			Scope(Scope const&) = delete;
+			Scope& operator=(Scope const&) = delete;
+		};
+	};
+}
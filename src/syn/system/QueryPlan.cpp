@@ -0,0 +1,173 @@
+#include "syn/syn.h"
+#include "QueryPlan.h"
+
+using namespace syn;
+
+using Node = Graph::Node;
+
+/******************************************************************************
+** QueryPlan::Scratch
+******************************************************************************/
+
+QueryPlan::Scratch::Scratch()
+	: _frontier()
+	, _next()
+	, _seen(16, nullptr)
+	, _seenCount(0)
+{ }
+
+void QueryPlan::Scratch::_clearSeen()
+{
+	if (_seenCount != 0)
+		std::fill(_seen.begin(), _seen.end(), nullptr);
+	_seenCount = 0;
+}
+
+bool QueryPlan::Scratch::_insertSeen(Node const* node)
+{
+	// Kept at most half full
+	if ((_seenCount + 1) * 2 > _seen.size())
+	{
+		std::vector<Node const*> old(_seen.size() * 2, nullptr);
+		old.swap(_seen);
+		_seenCount = 0;
+		for (auto n : old)
+			if (n != nullptr)
+				_insertSeen(n);
+	}
+
+	auto mask = _seen.size() - 1;
+	auto i = (size_t)(((uint64_t)(uintptr_t)node * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+	for (; _seen[i] != nullptr; i = (i + 1) & mask)
+		if (_seen[i] == node)
+			return false;
+
+	_seen[i] = node;
+	_seenCount += 1;
+	return true;
+}
+
+/******************************************************************************
+** QueryPlan::Memo
+******************************************************************************/
+
+QueryPlan::Memo::Memo(QueryPlan const& plan)
+	: _plan(plan)
+	, _entries()
+	, _scratch()
+{ }
+
+std::vector<Node const*> const& QueryPlan::Memo::run(TypeStore const& store, Node const* start)
+{
+	// Read before running, so a change made meanwhile is seen by the next run
+	auto revision = store.revision();
+
+	auto found = _entries.try_emplace(start);
+	auto& entry = found.first->second;
+	if (!found.second && entry.revision == revision)
+		return entry.results;
+
+	_plan.run(store, start, _scratch);
+	entry.revision = revision;
+	entry.results.assign(_scratch.results().begin(), _scratch.results().end());
+	return entry.results;
+}
+
+/******************************************************************************
+** QueryPlan
+******************************************************************************/
+
+QueryPlan::QueryPlan()
+	: _steps()
+	, _limit(std::numeric_limits<size_t>::max())
+{ }
+
+QueryPlan& QueryPlan::out(TypeId edge)
+{
+	_steps.push_back({ edge, true, false });
+	return *this;
+}
+
+QueryPlan& QueryPlan::in(TypeId edge)
+{
+	_steps.push_back({ edge, false, false });
+	return *this;
+}
+
+QueryPlan& QueryPlan::repeatOut(TypeId edge)
+{
+	_steps.push_back({ edge, true, true });
+	return *this;
+}
+
+QueryPlan& QueryPlan::repeatIn(TypeId edge)
+{
+	_steps.push_back({ edge, false, true });
+	return *this;
+}
+
+QueryPlan& QueryPlan::take(size_t count)
+{
+	_limit = count;
+	return *this;
+}
+
+bool QueryPlan::_run(TypeStore const& store, Node const* start, size_t limit, Node const* target, Scratch& scratch) const
+{
+	bool reached = false;
+	auto& frontier = scratch._frontier;
+	auto& next = scratch._next;
+
+	frontier.clear();
+	frontier.push_back(start);
+
+	for (size_t s = 0; s < _steps.size() && !frontier.empty(); ++s)
+	{
+		auto const& step = _steps[s];
+		auto const last = s + 1 == _steps.size();
+		auto const cap = last ? limit : std::numeric_limits<size_t>::max();
+
+		next.clear();
+		scratch._clearSeen();
+
+		auto visit = [&](Node const* n)
+		{
+			if (next.size() >= cap || reached || !scratch._insertSeen(n))
+				return;
+
+			next.push_back(n);
+			reached = last && n == target;
+		};
+
+		for (auto n : frontier)
+			_forAllAdjacent(store, step, n, visit);
+
+		// Closures keep expanding what they reached, `next` doubles as the breadth first queue
+		if (step.repeat)
+			for (size_t i = 0; i < next.size() && next.size() < cap && !reached; ++i)
+				_forAllAdjacent(store, step, next[i], visit);
+
+		frontier.swap(next);
+	}
+
+	return reached || (_steps.empty() && start == target);
+}
+
+size_t QueryPlan::run(TypeStore const& store, Node const* start, Scratch& scratch) const
+{
+	_run(store, start, _limit, nullptr, scratch);
+	return scratch._frontier.size();
+}
+
+size_t QueryPlan::run(TypeStore const& store, Node const* start, Node const** results, size_t capacity, Scratch& scratch) const
+{
+	_run(store, start, std::min(_limit, capacity), nullptr, scratch);
+	auto count = std::min(scratch._frontier.size(), capacity);
+	std::copy(scratch._frontier.begin(), scratch._frontier.begin() + count, results);
+	return count;
+}
+
+bool QueryPlan::reaches(TypeStore const& store, Node const* start, Node const* target, Scratch& scratch) const
+{
+	return target != nullptr && _run(store, start, _limit, target, scratch);
+}
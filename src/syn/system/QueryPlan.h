@@ -0,0 +1,126 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** QueryPlan
+	******************************************************************************/
+
+	/* A traversal of the graph built once and run many times.
+	 *
+	 * A plan is a list of steps, each following edges of one type (from their first node to their
+	 * second, or back), optionally repeated to a closure. Runs go through a `TypeStore`, so they
+	 * see an overlay's base and skip retired edges (and once it is frozen, only look at the edges of
+	 * a step's type), and keep everything they need in a `Scratch` the caller reuses, so once it has
+	 * grown a run does not allocate.
+	 */
+	class QueryPlan final
+	{
+	public:
+		// Working storage for runs, keeps it's capacity between them. One per thread (or run).
+		class Scratch final
+		{
+		private:
+			friend class QueryPlan;
+
+			std::vector<Graph::Node const*> _frontier;
+			std::vector<Graph::Node const*> _next;
+			// Open addressed, a power of two in size
+			std::vector<Graph::Node const*> _seen;
+			size_t _seenCount;
+
+			void _clearSeen();
+			bool _insertSeen(Graph::Node const*);
+
+		public:
+			CULTLANG_SYNDICATE_EXPORTED Scratch();
+
+			// The results of the last `run` given this scratch without a result buffer.
+			inline std::vector<Graph::Node const*> const& results() const { return _frontier; }
+		};
+
+		// Results of a plan by start node, recomputed once the store's revision moves. Not
+		// synchronized, and `run` invalidates the results of earlier runs when it recomputes.
+		class Memo final
+		{
+		private:
+			struct _Entry
+			{
+				uint64_t revision;
+				std::vector<Graph::Node const*> results;
+			};
+
+			QueryPlan const& _plan;
+			std::unordered_map<Graph::Node const*, _Entry> _entries;
+			Scratch _scratch;
+
+		public:
+			CULTLANG_SYNDICATE_EXPORTED Memo(QueryPlan const& plan);
+
+			CULTLANG_SYNDICATE_EXPORTED std::vector<Graph::Node const*> const& run(TypeStore const& store, Graph::Node const* start);
+
+			inline void clear() { _entries.clear(); }
+		};
+
+	private:
+		struct _Step
+		{
+			TypeId edge;
+			bool outgoing;
+			bool repeat;
+		};
+
+		std::vector<_Step> _steps;
+		size_t _limit;
+
+		template<typename TFunc>
+		inline static void _forAllAdjacent(TypeStore const& store, _Step const& step, Graph::Node const* node, TFunc const& f);
+
+		// Stops early once `target` (if any) is reached by the last step, returning whether it was.
+		bool _run(TypeStore const& store, Graph::Node const* start, size_t limit, Graph::Node const* target, Scratch& scratch) const;
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED QueryPlan();
+
+		// Follows edges of type `edge` from their first node to their second.
+		CULTLANG_SYNDICATE_EXPORTED QueryPlan& out(TypeId edge);
+		// Follows edges of type `edge` from their second node to their first.
+		CULTLANG_SYNDICATE_EXPORTED QueryPlan& in(TypeId edge);
+		// As `out` and `in`, but any number of times (at least once), breadth first.
+		CULTLANG_SYNDICATE_EXPORTED QueryPlan& repeatOut(TypeId edge);
+		CULTLANG_SYNDICATE_EXPORTED QueryPlan& repeatIn(TypeId edge);
+		// Stops once `count` results are found.
+		CULTLANG_SYNDICATE_EXPORTED QueryPlan& take(size_t count);
+
+		inline size_t stepCount() const { return _steps.size(); }
+
+		// The distinct nodes reached by the last step, into `scratch.results()`. Returns how many.
+		CULTLANG_SYNDICATE_EXPORTED size_t run(TypeStore const& store, Graph::Node const* start, Scratch& scratch) const;
+
+		// As above, but writes at most `capacity` results to `results`.
+		CULTLANG_SYNDICATE_EXPORTED size_t run(TypeStore const& store, Graph::Node const* start, Graph::Node const** results, size_t capacity, Scratch& scratch) const;
+
+		// Whether `target` is among the results, stopping as soon as it is reached.
+		CULTLANG_SYNDICATE_EXPORTED bool reaches(TypeStore const& store, Graph::Node const* start, Graph::Node const* target, Scratch& scratch) const;
+	};
+
+	/******************************************************************************
+	** QueryPlan inline defines
+	******************************************************************************/
+
+	template<typename TFunc>
+	inline void QueryPlan::_forAllAdjacent(TypeStore const& store, _Step const& step, Graph::Node const* node, TFunc const& f)
+	{
+		store.forAllEdgesOfTypeOnNode(node, (Graph::Node const*)step.edge, [&](auto e)
+		{
+			if (e->nodes.size() != 2 || store.isRetired(e))
+				return;
+
+			auto from = store.canonical((Graph::Node const*)e->nodes[0]);
+			auto to = store.canonical((Graph::Node const*)e->nodes[1]);
+			if (step.outgoing ? from == node : to == node)
+				f(step.outgoing ? to : from);
+		});
+	}
+}
@@ -0,0 +1,168 @@
+#include "syn/syn.h"
+#include "Snapshot.h"
+
+#ifdef _WIN32
+#include "Windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace syn;
+
+/******************************************************************************
+** Snapshot
+******************************************************************************/
+
+namespace
+{
+	char const SnapshotMagic[8] = { 'S', 'Y', 'N', 'S', 'N', 'A', 'P', '\0' };
+
+	inline size_t padded(size_t size)
+	{
+		return (size + alignof(size_t) - 1) & ~(alignof(size_t) - 1);
+	}
+}
+
+Snapshot::Snapshot()
+	: _data(nullptr)
+	, _size(0)
+	, _mapping(nullptr)
+{ }
+
+Snapshot::~Snapshot()
+{
+	if (_data == nullptr)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle((HANDLE)_mapping);
+#else
+	munmap(const_cast<void*>(_data), _size);
+#endif
+}
+
+std::shared_ptr<Snapshot> Snapshot::open(std::string const& path)
+{
+	std::shared_ptr<Snapshot> res(new Snapshot());
+
+#ifdef _WIN32
+	auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(_Header))
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return nullptr;
+
+	auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		return nullptr;
+	}
+
+	res->_data = data;
+	res->_size = (size_t)size.QuadPart;
+	res->_mapping = mapping;
+#else
+	auto fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(_Header))
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	auto data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	res->_data = data;
+	res->_size = (size_t)info.st_size;
+#endif
+
+	auto const& header = res->_header();
+	if (std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+		|| header.version != Version
+		|| header.pointerSize != sizeof(void*)
+		|| header.symbolsOffset > res->_size
+		|| header.symbolsSize > res->_size - header.symbolsOffset)
+		return nullptr;
+
+	return res;
+}
+
+void Snapshot::write(std::string const& path, TypeStore const& store, uint64_t fingerprint)
+{
+	auto const& symbols = store.s();
+
+	// Every symbol in id order, in the arena's layout
+	std::string body;
+	auto count = symbols.count();
+	for (size_t id = 1; id <= count; ++id)
+	{
+		auto entry = symbols._entryIfAllocated((uint32_t)id)->load(std::memory_order_acquire);
+		auto size = sizeof(size_t) + SymbolTable::_view(entry).size() + 1;
+		body.append(entry, size);
+		body.append(padded(size) - size, '\0');
+	}
+
+	_Header header;
+	std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+	header.version = Version;
+	header.pointerSize = sizeof(void*);
+	header.fingerprint = fingerprint;
+	header.symbolCount = count;
+	header.symbolsOffset = padded(sizeof(_Header));
+	header.symbolsSize = body.size();
+
+	// Other processes may be reading the old image or writing their own
+	auto temp = fmt::format("{0}.{1}.tmp", path, std::chrono::steady_clock::now().time_since_epoch().count());
+	{
+		std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+		if (!file)
+			throw stdext::exception("Could not write snapshot `{0}`.", temp);
+
+		file.write(reinterpret_cast<char const*>(&header), sizeof(_Header));
+		file.write(std::string(header.symbolsOffset - sizeof(_Header), '\0').data(), header.symbolsOffset - sizeof(_Header));
+		file.write(body.data(), body.size());
+		if (!file)
+			throw stdext::exception("Could not write snapshot `{0}`.", temp);
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temp, error);
+		throw stdext::exception("Could not replace snapshot `{0}`.", path);
+	}
+}
+
+void Snapshot::seed(TypeStore& store) const
+{
+	auto const& header = _header();
+	auto self = shared_from_this();
+
+	store.s()._seed(
+		reinterpret_cast<char const*>(_data) + header.symbolsOffset,
+		(size_t)header.symbolsSize,
+		(size_t)header.symbolCount,
+		std::shared_ptr<void const>(self, _data));
+}
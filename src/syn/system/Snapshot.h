@@ -0,0 +1,63 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** Snapshot
+	******************************************************************************/
+
+	/* A position independent file image of the parts of a `TypeStore` that can outlive a process.
+	 *
+	 * Today that is the symbol table: the image holds every symbol in id order in the same layout
+	 * the table's arena uses, so `seed` maps it into a fresh table without copying a string. The
+	 * image also records a fingerprint of the registered defines (see `CppSystem::fingerprint`)
+	 * so a boot can tell whether it was written by the same set of defines.
+	 *
+	 * The graph itself is not part of the image, it's payloads hold process local pointers
+	 * (function pointers, `CppDefine`s, boxed values), so initers still run on every boot.
+	 */
+	class Snapshot final
+		: public std::enable_shared_from_this<Snapshot>
+	{
+	public:
+		static constexpr uint32_t Version = 1;
+
+	private:
+		struct _Header
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t pointerSize;
+			uint64_t fingerprint;
+			uint64_t symbolCount;
+			uint64_t symbolsOffset;
+			uint64_t symbolsSize;
+		};
+
+		void const* _data;
+		size_t _size;
+		void* _mapping;
+
+		Snapshot();
+
+		inline _Header const& _header() const { return *reinterpret_cast<_Header const*>(_data); }
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED ~Snapshot();
+
+		Snapshot(Snapshot const&) = delete;
+		Snapshot& operator=(Snapshot const&) = delete;
+
+		// Maps the image at `path` read only, null if there is none or it is not a valid image.
+		CULTLANG_SYNDICATE_EXPORTED static std::shared_ptr<Snapshot> open(std::string const& path);
+		// Writes `store` to `path`, replacing any existing image atomically.
+		CULTLANG_SYNDICATE_EXPORTED static void write(std::string const& path, TypeStore const& store, uint64_t fingerprint);
+
+		inline uint64_t fingerprint() const { return _header().fingerprint; }
+		inline size_t symbolCount() const { return (size_t)_header().symbolCount; }
+
+		// Interns the image's symbols into `store`'s (empty) symbol table with the same ids.
+		CULTLANG_SYNDICATE_EXPORTED void seed(TypeStore& store) const;
+	};
+}
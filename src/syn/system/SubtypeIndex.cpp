@@ -0,0 +1,212 @@
+#include "syn/syn.h"
+#include "SubtypeIndex.h"
+
+using namespace syn;
+
+/******************************************************************************
+** SubtypeIndex
+******************************************************************************/
+
+SubtypeIndex::SubtypeIndex()
+	: _entries()
+	, _byIndex()
+	, _children()
+	, _parents()
+	, _nodes()
+{ }
+
+SubtypeIndex::~SubtypeIndex()
+{
+	for (auto entry : _byIndex)
+		delete entry->ancestors.load(std::memory_order_acquire);
+}
+
+size_t SubtypeIndex::count() const
+{
+	return _nodes.size();
+}
+
+uint32_t SubtypeIndex::_require(Graph::Node const* n)
+{
+	auto index = (uint32_t)_nodes.size();
+
+	// Readers may find the entry as soon as it is published, so it is complete before
+	auto& entry = _entries.require(n, [&](_Entry& fresh)
+	{
+		auto ancestors = new std::vector<uint64_t>((index >> 6) + 1, 0);
+		(*ancestors)[index >> 6] |= uint64_t(1) << (index & 63);
+
+		fresh.index = index;
+		fresh.ancestors.store(ancestors, std::memory_order_relaxed);
+	});
+	// Known already
+	if (entry.index != index)
+		return entry.index;
+
+	_byIndex.push_back(&entry);
+	_children.emplace_back();
+	_parents.emplace_back();
+	_nodes.push_back(n);
+	return index;
+}
+
+void SubtypeIndex::addIsA(Graph::Node const* sub, Graph::Node const* super)
+{
+	auto sub_index = _require(sub);
+	auto super_index = _require(super);
+
+	_children[super_index].push_back(sub_index);
+	_parents[sub_index].push_back(super_index);
+
+	// Held, `super` may be among the descendants we replace (cycles are allowed in the graph).
+	Epoch::Guard guard;
+	auto const& added = *_byIndex[super_index]->ancestors.load(std::memory_order_acquire);
+
+	std::vector<uint32_t> work { sub_index };
+	while (!work.empty())
+	{
+		auto current = work.back();
+		work.pop_back();
+
+		auto& entry = *_byIndex[current];
+		auto ancestors = entry.ancestors.load(std::memory_order_relaxed);
+
+		bool changed = ancestors->size() < added.size();
+		for (size_t i = 0; i < added.size() && !changed; ++i)
+			changed = ((*ancestors)[i] | added[i]) != (*ancestors)[i];
+
+		// Descendants already carrying every bit were updated by an earlier edge.
+		if (!changed)
+			continue;
+
+		auto merged = new std::vector<uint64_t>(*ancestors);
+		if (merged->size() < added.size())
+			merged->resize(added.size(), 0);
+		for (size_t i = 0; i < added.size(); ++i)
+			(*merged)[i] |= added[i];
+
+		entry.ancestors.store(merged, std::memory_order_release);
+		Epoch::retire(const_cast<std::vector<uint64_t>*>(ancestors));
+
+		work.insert(work.end(), _children[current].begin(), _children[current].end());
+	}
+}
+
+void SubtypeIndex::removeIsA(Graph::Node const* sub, Graph::Node const* super, std::function<void(Graph::Node const*)> const& f)
+{
+	auto sub_index = indexOf(sub), super_index = indexOf(super);
+	if (sub_index == ~uint32_t(0) || super_index == ~uint32_t(0))
+		return;
+
+	auto& children = _children[super_index];
+	auto removed = std::remove(children.begin(), children.end(), sub_index);
+	if (removed == children.end())
+		return;
+	children.erase(removed, children.end());
+	auto& parents = _parents[sub_index];
+	parents.erase(std::remove(parents.begin(), parents.end(), super_index), parents.end());
+
+	// Only `sub` and what is below it can lose ancestors
+	constexpr auto npos = ~uint32_t(0);
+	std::vector<uint32_t> affected, position(_nodes.size(), npos);
+	std::vector<uint32_t> work { sub_index };
+	while (!work.empty())
+	{
+		auto current = work.back();
+		work.pop_back();
+		if (position[current] != npos)
+			continue;
+
+		position[current] = (uint32_t)affected.size();
+		affected.push_back(current);
+		work.insert(work.end(), _children[current].begin(), _children[current].end());
+	}
+
+	// Each starts from itself and the parents outside of the affected, whose bits stand
+	auto words = (_nodes.size() + 63) >> 6;
+	std::vector<std::vector<uint64_t>> bits(affected.size(), std::vector<uint64_t>(words, 0));
+	for (size_t k = 0; k < affected.size(); ++k)
+	{
+		bits[k][affected[k] >> 6] |= uint64_t(1) << (affected[k] & 63);
+		for (auto parent : _parents[affected[k]])
+		{
+			if (position[parent] != npos)
+				continue;
+
+			auto const& inherited = ancestors(parent);
+			for (size_t i = 0; i < inherited.size(); ++i)
+				bits[k][i] |= inherited[i];
+		}
+	}
+
+	// Then takes in those of the affected parents, until nothing changes (cycles are allowed)
+	for (uint32_t k = 0; k < affected.size(); ++k)
+		work.push_back(k);
+	while (!work.empty())
+	{
+		auto k = work.back();
+		work.pop_back();
+
+		for (auto child : _children[affected[k]])
+		{
+			auto c = position[child];
+			if (c == npos)
+				continue;
+
+			bool changed = false;
+			for (size_t i = 0; i < words; ++i)
+			{
+				auto merged = bits[c][i] | bits[k][i];
+				changed |= merged != bits[c][i];
+				bits[c][i] = merged;
+			}
+			if (changed)
+				work.push_back(c);
+		}
+	}
+
+	for (size_t k = 0; k < affected.size(); ++k)
+	{
+		auto& entry = *_byIndex[affected[k]];
+		auto previous = entry.ancestors.load(std::memory_order_relaxed);
+
+		// Only ever loses bits
+		bool changed = false;
+		for (size_t i = 0; i < previous->size(); ++i)
+		{
+			auto lost = (*previous)[i] & ~bits[k][i];
+			changed |= lost != 0;
+			for (size_t b = 0; lost != 0; ++b, lost >>= 1)
+				if ((lost & 1) != 0)
+					f(_nodes[(i << 6) + b]);
+		}
+		if (!changed)
+			continue;
+
+		entry.ancestors.store(new std::vector<uint64_t>(std::move(bits[k])), std::memory_order_release);
+		Epoch::retire(const_cast<std::vector<uint64_t>*>(previous));
+	}
+}
+
+void SubtypeIndex::forAllDescendants(Graph::Node const* super, std::function<void(Graph::Node const*)> const& f) const
+{
+	auto index = indexOf(super);
+	if (index == ~uint32_t(0))
+		return;
+
+	std::vector<bool> seen(_nodes.size(), false);
+	seen[index] = true;
+
+	std::vector<uint32_t> work(_children[index]);
+	while (!work.empty())
+	{
+		auto current = work.back();
+		work.pop_back();
+		if (seen[current])
+			continue;
+
+		seen[current] = true;
+		f(_nodes[current]);
+		work.insert(work.end(), _children[current].begin(), _children[current].end());
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** SubtypeIndex
+	******************************************************************************/
+
+	/* A precomputed closure of the `EIsA` edges, used to answer `is_a` without a graph query.
+	 *
+	 * Every node taking part in an `EIsA` edge is given a dense index, and a bit vector of all of
+	 * it's ancestors (including itself). Multiple inheritance is just more bits. Adding an edge
+	 * pushes the new ancestors down to every known descendant, so a query is a hash probe and a
+	 * bit test. Removing one recomputes the bits of the sub and it's descendants, the rest keep
+	 * theirs.
+	 *
+	 * `isA` and `indexOf` are lock free: the nodes are a `LockFreeMap`, and each node's bits are
+	 * an immutable vector which an edge adding ancestors replaces (retiring the old one through
+	 * `Epoch`). Writers, and readers of the rest (`count`, `ancestors` and `forAllDescendants`),
+	 * serialize among themselves (the store's write lock).
+	 */
+	class SubtypeIndex final
+	{
+	private:
+		struct _Entry
+		{
+			uint32_t index;
+			std::atomic<std::vector<uint64_t> const*> ancestors;
+		};
+
+		LockFreeMap<Graph::Node const*, _Entry> _entries;
+
+		// By index, only used by writers
+		std::vector<_Entry*> _byIndex;
+		std::vector<std::vector<uint32_t>> _children;
+		std::vector<std::vector<uint32_t>> _parents;
+		std::vector<Graph::Node const*> _nodes;
+
+		uint32_t _require(Graph::Node const*);
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED SubtypeIndex();
+		CULTLANG_SYNDICATE_EXPORTED ~SubtypeIndex();
+
+		SubtypeIndex(SubtypeIndex const&) = delete;
+		SubtypeIndex& operator=(SubtypeIndex const&) = delete;
+
+		CULTLANG_SYNDICATE_EXPORTED size_t count() const;
+
+		// Records that `sub` is-a `super`, propagating to all of `sub`'s descendants.
+		CULTLANG_SYNDICATE_EXPORTED void addIsA(Graph::Node const* sub, Graph::Node const* super);
+
+		// Forgets every record of `sub` is-a `super`. Calls `f` with each ancestor `sub` or one of
+		// it's descendants lost (once for every node losing it), never if other paths still relate
+		// them.
+		CULTLANG_SYNDICATE_EXPORTED void removeIsA(Graph::Node const* sub, Graph::Node const* super, std::function<void(Graph::Node const*)> const& f);
+
+		// The dense index of `node`, or `~0` if it takes part in no `EIsA` edge.
+		inline uint32_t indexOf(Graph::Node const* node) const
+		{
+			Epoch::Guard guard;
+			auto entry = _entries.find(node);
+			return entry != nullptr ? entry->index : ~uint32_t(0);
+		}
+
+		// The ancestor bits of the node at `index` (see `indexOf`), bit `i` for the node at index `i`.
+		inline std::vector<uint64_t> const& ancestors(uint32_t index) const { return *_byIndex[index]->ancestors.load(std::memory_order_acquire); }
+
+		// Calls `f` once for every node known to be-a `super`, not including `super` itself.
+		CULTLANG_SYNDICATE_EXPORTED void forAllDescendants(Graph::Node const* super, std::function<void(Graph::Node const*)> const& f) const;
+
+		inline bool isA(Graph::Node const* sub, Graph::Node const* super) const
+		{
+			Epoch::Guard guard;
+			auto sub_entry = _entries.find(sub);
+			if (sub_entry == nullptr) return false;
+			auto super_entry = _entries.find(super);
+			if (super_entry == nullptr) return false;
+
+			auto const& ancestors = *sub_entry->ancestors.load(std::memory_order_acquire);
+			auto word = super_entry->index >> 6;
+			return word < ancestors.size()
+				&& (ancestors[word] & (uint64_t(1) << (super_entry->index & 63))) != 0;
+		}
+	};
+}
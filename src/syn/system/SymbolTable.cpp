@@ -7,44 +7,266 @@ using namespace syn;
 ** SymbolTable
 ******************************************************************************/
 
+namespace
+{
+    inline size_t floor_log2(uint64_t v)
+    {
+        size_t res = 0;
+        for (size_t shift = 32; shift != 0; shift /= 2)
+            if (v >> shift) { v >>= shift; res += shift; }
+        return res;
+    }
+}
+
+SymbolTable::_Index::_Index(size_t size)
+    : mask(size - 1)
+    , slots(new std::atomic<uint64_t>[size])
+{
+    for (size_t i = 0; i < size; ++i)
+        slots[i].store(0, std::memory_order_relaxed);
+}
+
 SymbolTable::SymbolTable()
     : _id(0)
-    , _strToId()
-    , _idToStr()
-{ }
+{
+    for (auto& shard : _shards)
+    {
+        shard.indexes.emplace_back(new _Index(16));
+        shard.index.store(shard.indexes.back().get(), std::memory_order_relaxed);
+        shard.count = 0;
+        shard.arenaUsed = _ArenaBlockSize;
+    }
+    for (auto& page : _pages)
+        page.store(nullptr, std::memory_order_relaxed);
+}
 
-std::string SymbolTable::getString(Symbol sym) const
+SymbolTable::~SymbolTable()
 {
-    return _idToStr.at(sym);
+    for (auto& page : _pages)
+        delete[] page.load(std::memory_order_relaxed);
 }
 
-Symbol SymbolTable::getSymbol(std::string const& str) const
+char const* SymbolTable::_store(_Shard& shard, std::string_view str)
 {
-    return _strToId.at(str);
+    // Strings are stored length prefixed and null terminated, large ones get a block of their own
+    auto size = (sizeof(size_t) + str.size() + alignof(size_t)) & ~(alignof(size_t) - 1);
+    char* dst;
+    if (size > _ArenaBlockSize / 4)
+    {
+        shard.arena.emplace_back(new char[size]);
+        dst = shard.arena.back().get();
+
+        // Keep filling the current block
+        if (shard.arena.size() > 1)
+            std::swap(shard.arena[shard.arena.size() - 1], shard.arena[shard.arena.size() - 2]);
+    }
+    else
+    {
+        if (shard.arenaUsed + size > _ArenaBlockSize)
+        {
+            shard.arena.emplace_back(new char[_ArenaBlockSize]);
+            shard.arenaUsed = 0;
+        }
+        dst = shard.arena.back().get() + shard.arenaUsed;
+        shard.arenaUsed += size;
+    }
+
+    size_t length = str.size();
+    std::memcpy(dst, &length, sizeof(size_t));
+    std::memcpy(dst + sizeof(size_t), str.data(), str.size());
+    dst[sizeof(size_t) + str.size()] = '\0';
+    return dst;
 }
 
-Symbol SymbolTable::require(std::string const& str)
+void SymbolTable::_seed(char const* entries, size_t size, size_t count, std::shared_ptr<void const> image)
 {
-    decltype(_strToId)::iterator lb = _strToId.lower_bound(str);
+    if (_id.load(std::memory_order_relaxed) != 0)
+        throw stdext::exception("Can only seed an empty symbol table.");
 
-    if(lb != _strToId.end() && !(_strToId.key_comp()(str, lb->first)))
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i)
     {
-        return lb->second;
+        size_t length;
+        if (offset + sizeof(size_t) > size)
+            throw stdext::exception("Symbol image is truncated.");
+        std::memcpy(&length, entries + offset, sizeof(size_t));
+        // Room for the string and it's terminator after the length
+        if (length + 1 > size - offset - sizeof(size_t))
+            throw stdext::exception("Symbol image is truncated.");
+
+        auto entry = entries + offset;
+        auto str = _view(entry);
+        auto h = hash(str);
+        auto& shard = _shards[h >> (64 - _ShardBits)];
+
+        std::lock_guard<std::mutex> lock(shard.write);
+        auto id = _id.fetch_add(1, std::memory_order_acq_rel) + 1;
+        _entry(id).store(entry, std::memory_order_release);
+        _insert(shard, h, id);
+
+        offset += (sizeof(size_t) + length + alignof(size_t)) & ~(alignof(size_t) - 1);
     }
-    else
+
+    _image = std::move(image);
+}
+
+std::string_view SymbolTable::_view(char const* entry)
+{
+    size_t length;
+    std::memcpy(&length, entry, sizeof(size_t));
+    return std::string_view(entry + sizeof(size_t), length);
+}
+
+SymbolTable::_Entry& SymbolTable::_entry(uint32_t id)
+{
+    auto page = floor_log2((id >> _FirstPageBits) + 1);
+    auto offset = id - (((size_t(1) << page) - 1) << _FirstPageBits);
+
+    auto entries = _pages[page].load(std::memory_order_acquire);
+    if (entries == nullptr)
     {
-        auto sym = (Symbol)++_id;
+        // Shards allocate pages independently, the first to publish wins
+        auto size = (size_t(1) << _FirstPageBits) << page;
+        auto fresh = new _Entry[size];
+        for (size_t i = 0; i < size; ++i)
+            fresh[i].store(nullptr, std::memory_order_relaxed);
 
-        _strToId.insert(lb, decltype(_strToId)::value_type(str, sym));
-        _idToStr[sym] = str;
+        if (_pages[page].compare_exchange_strong(entries, fresh, std::memory_order_acq_rel))
+            entries = fresh;
+        else
+            delete[] fresh;
+    }
 
-        return sym;
+    return entries[offset];
+}
+
+SymbolTable::_Entry const* SymbolTable::_entryIfAllocated(uint32_t id) const
+{
+    auto page = floor_log2((id >> _FirstPageBits) + 1);
+    auto offset = id - (((size_t(1) << page) - 1) << _FirstPageBits);
+
+    auto entries = _pages[page].load(std::memory_order_acquire);
+    return entries == nullptr ? nullptr : entries + offset;
+}
+
+uint32_t SymbolTable::_find(_Index const* index, std::string_view str, uint64_t hash) const
+{
+    auto tag = hash >> 32;
+    for (auto i = hash & index->mask; ; i = (i + 1) & index->mask)
+    {
+        auto slot = index->slots[i].load(std::memory_order_acquire);
+        auto id = (uint32_t)slot;
+        if (id == 0)
+            return 0;
+
+        // Slots are published after their entry
+        if ((slot >> 32) == tag && _view(_entryIfAllocated(id)->load(std::memory_order_relaxed)) == str)
+            return id;
+    }
+}
+
+void SymbolTable::_insert(_Shard& shard, uint64_t hash, uint32_t id)
+{
+    auto index = shard.index.load(std::memory_order_relaxed);
+
+    // Keep the load factor at or below a half, readers may still be probing the old index
+    if ((shard.count + 1) * 2 > index->mask + 1)
+    {
+        auto grown = new _Index((index->mask + 1) * 2);
+        for (size_t i = 0; i <= index->mask; ++i)
+        {
+            auto slot = index->slots[i].load(std::memory_order_relaxed);
+            if ((uint32_t)slot == 0)
+                continue;
+
+            // Slots only keep the high half of the hash, the probe starts from the low half
+            auto h = SymbolTable::hash(_view(_entryIfAllocated((uint32_t)slot)->load(std::memory_order_relaxed)));
+            auto j = h & grown->mask;
+            while (grown->slots[j].load(std::memory_order_relaxed) != 0)
+                j = (j + 1) & grown->mask;
+            grown->slots[j].store(slot, std::memory_order_relaxed);
+        }
+
+        shard.indexes.emplace_back(grown);
+        shard.index.store(grown, std::memory_order_release);
+        index = grown;
     }
+
+    auto i = hash & index->mask;
+    while (index->slots[i].load(std::memory_order_relaxed) != 0)
+        i = (i + 1) & index->mask;
+    index->slots[i].store(((hash >> 32) << 32) | id, std::memory_order_release);
+    shard.count += 1;
+}
+
+std::string_view SymbolTable::getString(Symbol sym) const
+{
+    auto id = (uintptr_t)sym;
+    char const* entry = nullptr;
+    if (id != 0 && id <= _id.load(std::memory_order_acquire))
+    {
+        auto e = _entryIfAllocated((uint32_t)id);
+        if (e != nullptr)
+            entry = e->load(std::memory_order_acquire);
+    }
+
+    if (entry == nullptr)
+        throw stdext::exception("Unknown symbol {0}.", id);
+    return _view(entry);
+}
+
+Symbol SymbolTable::getSymbol(std::string_view str) const
+{
+    auto sym = find(str);
+    if ((uintptr_t)sym == 0)
+        throw stdext::exception("No symbol for `{0}`.", std::string(str));
+    return sym;
+}
+
+Symbol SymbolTable::find(std::string_view str) const
+{
+    return _find(str, hash(str));
+}
+
+Symbol SymbolTable::require(std::string_view str)
+{
+    return _require(str, hash(str));
+}
+
+Symbol SymbolTable::_find(std::string_view str, uint64_t h) const
+{
+    auto& shard = _shards[h >> (64 - _ShardBits)];
+    return (Symbol)_find(shard.index.load(std::memory_order_acquire), str, h);
+}
+
+Symbol SymbolTable::_require(std::string_view str, uint64_t h)
+{
+    auto& shard = _shards[h >> (64 - _ShardBits)];
+
+    auto found = _find(shard.index.load(std::memory_order_acquire), str, h);
+    if (found != 0)
+        return (Symbol)found;
+
+    std::lock_guard<std::mutex> lock(shard.write);
+
+    // Another thread may have inserted it (or grown the index) while we waited
+    found = _find(shard.index.load(std::memory_order_relaxed), str, h);
+    if (found != 0)
+        return (Symbol)found;
+
+    auto id = _id.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (id == 0)
+        throw stdext::exception("Symbol table is full.");
+
+    _entry(id).store(_store(shard, str), std::memory_order_release);
+    _insert(shard, h, id);
+
+    return (Symbol)id;
 }
 
 size_t SymbolTable::count() const
 {
-    return _id;
+    return _id.load(std::memory_order_acquire);
 }
 
 /******************************************************************************
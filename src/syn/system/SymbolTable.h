@@ -3,73 +3,272 @@
 
 namespace syn
 {
+	/******************************************************************************
+	** SymbolLiteral
+	******************************************************************************/
+
+	/* A string hashed at compile time, e.g. `"foo"_sym`, which tables can look up without hashing.
+	 *
+	 * See `SYN_SYMBOL` for a literal that is also only looked up once.
+	 */
+	struct SymbolLiteral final
+	{
+		std::string_view string;
+		uint64_t hash;
+
+		explicit constexpr SymbolLiteral(std::string_view str);
+	};
+
+	inline namespace literals
+	{
+		constexpr SymbolLiteral operator""_sym(char const* str, size_t size)
+		{
+			return SymbolLiteral(std::string_view(str, size));
+		}
+	}
+
 	/******************************************************************************
 	** SymbolTable
 	******************************************************************************/
 
+	/* Interns strings as dense, sequential `Symbol` ids (starting at 1).
+	 *
+	 * Strings are copied once into an append only arena, so the `std::string_view`s handed out
+	 * stay valid for the life of the table. Every lookup takes a `std::string_view`, so literals and
+	 * `std::string`s can be looked up without allocating.
+	 *
+	 * Safe to use from many threads. Lookups of interned strings (`find`, `getSymbol`, `getString`,
+	 * and `require` of an existing string) never lock. The hash index is split into shards by the
+	 * top bits of the hash, each with it's own lock and arena, so only new strings landing in the
+	 * same shard contend. Ids still come from one counter, so they stay dense.
+	 */
 	class SymbolTable
 	{
         private:
-            uintptr_t _id;
+            friend class Snapshot;
+
+            static constexpr size_t _ShardBits = 4;
+            static constexpr size_t _ShardCount = size_t(1) << _ShardBits;
+            static constexpr size_t _ArenaBlockSize = 4 * 1024;
+            // Id pages double in size, `_PageCount` of them cover every 32 bit id
+            static constexpr size_t _FirstPageBits = 8;
+            static constexpr size_t _PageCount = 32 - _FirstPageBits + 1;
 
-            // TODO replace this implementation
-            std::map<std::string, Symbol> _strToId;
-            std::map<Symbol, std::string> _idToStr;
+            // Open addressed, each slot packs 32 bits of the hash above the id (0 is empty).
+            struct _Index
+            {
+                size_t mask;
+                std::unique_ptr<std::atomic<uint64_t>[]> slots;
+
+                _Index(size_t size);
+            };
+
+            struct _Shard
+            {
+                std::mutex write;
+                std::atomic<_Index*> index;
+                size_t count;
+
+                // Guarded by `write`, superseded indexes are kept for readers still probing them
+                std::vector<std::unique_ptr<_Index>> indexes;
+                std::vector<std::unique_ptr<char[]>> arena;
+                size_t arenaUsed;
+            };
+
+            // Arena entries are a `size_t` length followed by the null terminated string
+            typedef std::atomic<char const*> _Entry;
+
+            std::atomic<uint32_t> _id;
+            _Shard _shards[_ShardCount];
+            std::atomic<_Entry*> _pages[_PageCount];
+            // Keeps a mapped image alive when the table was seeded from one
+            std::shared_ptr<void const> _image;
+
+            char const* _store(_Shard&, std::string_view);
+            _Entry& _entry(uint32_t id);
+            _Entry const* _entryIfAllocated(uint32_t id) const;
+            uint32_t _find(_Index const*, std::string_view, uint64_t hash) const;
+            void _insert(_Shard&, uint64_t hash, uint32_t id);
+
+            CULTLANG_SYNDICATE_EXPORTED Symbol _find(std::string_view, uint64_t hash) const;
+            CULTLANG_SYNDICATE_EXPORTED Symbol _require(std::string_view, uint64_t hash);
+
+            static std::string_view _view(char const* entry);
+
+            // Interns `count` entries laid out like the arena (padded to `size_t`) without copying them.
+            void _seed(char const* entries, size_t size, size_t count, std::shared_ptr<void const> image);
+
+        public:
+            // FNV-1a, usable at compile time.
+            static constexpr uint64_t hash(std::string_view str)
+            {
+                uint64_t res = 14695981039346656037ull;
+                for (auto c : str)
+                    res = (res ^ (uint8_t)c) * 1099511628211ull;
+                return res;
+            }
 
         public:
             CULTLANG_SYNDICATE_EXPORTED SymbolTable();
+            CULTLANG_SYNDICATE_EXPORTED ~SymbolTable();
+
+            SymbolTable(SymbolTable const&) = delete;
+            SymbolTable& operator=(SymbolTable const&) = delete;
 
+            // Every id up to `count()` has been handed out, a `require` racing this call may not
+            // have published it's string yet.
             CULTLANG_SYNDICATE_EXPORTED size_t count() const;
 
-            CULTLANG_SYNDICATE_EXPORTED std::string getString(Symbol) const;
-            CULTLANG_SYNDICATE_EXPORTED Symbol getSymbol(std::string const&) const;
+            // Throws for unknown symbols, the view lives as long as the table.
+            CULTLANG_SYNDICATE_EXPORTED std::string_view getString(Symbol) const;
+            // Throws for unknown strings.
+            CULTLANG_SYNDICATE_EXPORTED Symbol getSymbol(std::string_view) const;
+            // `Symbol::Empty` (0) for unknown strings.
+            CULTLANG_SYNDICATE_EXPORTED Symbol find(std::string_view) const;
+            inline Symbol find(SymbolLiteral const& literal) const { return _find(literal.string, literal.hash); }
 
-            CULTLANG_SYNDICATE_EXPORTED Symbol require(std::string const&);
+            CULTLANG_SYNDICATE_EXPORTED Symbol require(std::string_view);
+            inline Symbol require(SymbolLiteral const& literal) { return _require(literal.string, literal.hash); }
         
         public:
 
+        /* A side table from `Symbol` to `TStore`.
+         *
+         * Symbol ids are small and dense, so values live in pages indexed by id with a bitmap of
+         * which are set, making `has`, `lookup` and `set` a couple of indexed loads. Ids past
+         * `DenseLimit` (only seen in very large tables) fall back to a hash map.
+         */
         template<typename TStore, TStore default_value>
         class Lookup
         {
+            public:
+                static constexpr size_t PageBits = 8;
+                static constexpr size_t PageSize = size_t(1) << PageBits;
+                static constexpr size_t DenseLimit = size_t(1) << 20;
+
             private:
-                std::map<Symbol, TStore> _map;
+                struct _Page
+                {
+                    uint64_t present[PageSize / 64];
+                    TStore values[PageSize];
+
+                    _Page()
+                    {
+                        std::fill(std::begin(present), std::end(present), 0);
+                        std::fill(std::begin(values), std::end(values), default_value);
+                    }
+                };
+
+                std::vector<std::unique_ptr<_Page>> _pages;
+                std::unordered_map<uintptr_t, TStore> _sparse;
+                size_t _count;
                 SymbolTable& _table;
 
+                inline _Page* _page(uintptr_t id) const
+                {
+                    auto page = id >> PageBits;
+                    return page < _pages.size() ? _pages[page].get() : nullptr;
+                }
+
+                inline static bool _present(_Page const* page, uintptr_t id)
+                {
+                    auto bit = id & (PageSize - 1);
+                    return page != nullptr && (page->present[bit / 64] >> (bit % 64)) & 1;
+                }
+
             public:
                 Lookup(SymbolTable& table)
-                    : _table(table)
+                    : _count(0)
+                    , _table(table)
                 { }
 
-                bool has(Symbol sym)
+                inline SymbolTable& table() const { return _table; }
+                inline size_t count() const { return _count; }
+
+                bool has(Symbol sym) const
                 {
-                    auto it = _map.find(sym);
+                    uintptr_t id = sym;
+                    if (id >= DenseLimit)
+                        return _sparse.find(id) != _sparse.end();
 
-                    return it != _map.end();
+                    return _present(_page(id), id);
                 }
 
-                TStore lookup(Symbol sym)
+                TStore lookup(Symbol sym) const
                 {
-                    auto it = _map.find(sym);
+                    uintptr_t id = sym;
+                    if (id >= DenseLimit)
+                    {
+                        auto it = _sparse.find(id);
+                        return it != _sparse.end()
+                            ? it->second
+                            : default_value;
+                    }
 
-                    return it != _map.end()
-                        ? *it
+                    // Unset values in a page are kept at the default
+                    auto page = _page(id);
+                    return page != nullptr
+                        ? page->values[id & (PageSize - 1)]
                         : default_value;
                 }
 
                 void set(Symbol sym, TStore const& value)
                 {
-                    _map[sym] = value;
+                    uintptr_t id = sym;
+                    if (id >= DenseLimit)
+                    {
+                        _count += _sparse.insert_or_assign(id, value).second ? 1 : 0;
+                        return;
+                    }
+
+                    auto page = id >> PageBits;
+                    if (page >= _pages.size())
+                        _pages.resize(page + 1);
+                    if (!_pages[page])
+                        _pages[page].reset(new _Page());
+
+                    auto& p = *_pages[page];
+                    auto bit = id & (PageSize - 1);
+                    auto& word = p.present[bit / 64];
+                    auto mask = uint64_t(1) << (bit % 64);
+                    if ((word & mask) == 0)
+                    {
+                        word |= mask;
+                        _count += 1;
+                    }
+                    p.values[bit] = value;
                 }
 
                 void erase(Symbol sym)
                 {
-                    _map.erase(sym);
+                    uintptr_t id = sym;
+                    if (id >= DenseLimit)
+                    {
+                        _count -= _sparse.erase(id);
+                        return;
+                    }
+
+                    auto page = _page(id);
+                    if (!_present(page, id))
+                        return;
+
+                    auto bit = id & (PageSize - 1);
+                    page->present[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+                    page->values[bit] = default_value;
+                    _count -= 1;
                 }
 
                 void clear()
                 {
-                    _map.clear();
+                    _pages.clear();
+                    _sparse.clear();
+                    _count = 0;
                 }
         };
 	};
+
+	constexpr SymbolLiteral::SymbolLiteral(std::string_view str)
+		: string(str)
+		, hash(SymbolTable::hash(str))
+	{ }
 }
@@ -7,18 +7,12 @@ using namespace syn;
 ** TypeId
 ******************************************************************************/
 
-/*
-CRAFT_TYPE_DEFINE(syn::TypeId)
-{
-	_.use<PStringer>().singleton<FunctionalStringer>([](instance<TypeId> n) -> std::string
-	{
-		return n->toString();
-	});
+syn::Define<syn::TypeId> syn::type_define<syn::TypeId>::Definition(
+	[](auto _) {
+		_.name("TypeId");
 
-	_.identify_byFullCppName("syn::TypeId");
-	_.defaults();
-}
- */
+        _.detectLifecycle();
+	});
 
 std::string TypeId::toString() const
 {
@@ -29,7 +23,7 @@ std::string TypeId::toString() const
 
 	std::string from, name;
 
-	auto module_name = thread_store().g().onlyPropOfTypeOnNode<core::PModuleSymbol>(_node);
+	auto module_name = thread_store().onlyPropOfTypeOnNode<core::PModuleSymbol>(_node);
 	if (module_name)
 	{
 		return fmt::format("<UnknownModule>:{0}", thread_store().s().getString(module_name->symbol));
@@ -0,0 +1,131 @@
+#include "syn/syn.h"
+#include "TypeOverlay.h"
+
+using namespace syn;
+
+using Node = Graph::Node;
+
+/******************************************************************************
+** TypeOverlay
+******************************************************************************/
+
+TypeOverlay::TypeOverlay(TypeStore const& base)
+	: _base(base)
+{ }
+TypeOverlay::~TypeOverlay()
+{ }
+
+void TypeOverlay::own(void const* element)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	_owned.insert(element);
+}
+
+bool TypeOverlay::owns(void const* element) const
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _owned.count(element) != 0;
+}
+
+Node* TypeOverlay::shadowOf(Node const* node) const
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	auto it = _shadows.find(node);
+	return it != _shadows.end() ? it->second : nullptr;
+}
+
+void TypeOverlay::addShadow(Node const* node, Node* shadow)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	_shadows.emplace(node, shadow);
+	_canonical.emplace(shadow, node);
+}
+
+Node const* TypeOverlay::canonical(Node const* node) const
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		auto it = _canonical.find(node);
+		if (it != _canonical.end())
+			return it->second;
+	}
+	return _base.canonical(node);
+}
+
+bool TypeOverlay::isA(Node const* sub, Node const* super) const
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _isA(_supers, sub, super);
+}
+
+void TypeOverlay::addIsA(Node const* sub, Node const* super)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	_addIsA(_supers, sub, super);
+}
+
+void TypeOverlay::resetIsA(std::vector<std::pair<Node const*, Node const*>> const& edges)
+{
+	_Supers rebuilt;
+	for (auto const& edge : edges)
+		_addIsA(rebuilt, edge.first, edge.second);
+
+	std::lock_guard<std::mutex> lock(_lock);
+	_supers.swap(rebuilt);
+}
+
+bool TypeOverlay::_isA(_Supers const& supers, Node const* sub, Node const* super) const
+{
+	if (sub == super || _base.isA(sub, super))
+		return true;
+
+	// Any other path leaves the base's closure by the overlay's edges of some node, and reaches
+	// `super` from one of the supers those lead to
+	for (auto const& from : supers)
+	{
+		if (from.first != sub && !_base.isA(sub, from.first))
+			continue;
+
+		for (auto to : from.second)
+			if (to == super || _base.isA(to, super))
+				return true;
+	}
+	return false;
+}
+
+void TypeOverlay::_addIsA(_Supers& supers, Node const* sub, Node const* super) const
+{
+	// What `super` reaches (itself, and the supers of nodes it is in the base)
+	std::vector<Node const*> reached { super };
+	for (auto const& from : supers)
+		if (from.first == super || _base.isA(super, from.first))
+			reached.insert(reached.end(), from.second.begin(), from.second.end());
+
+	// Everything reaching `sub` so far now reaches those as well
+	std::vector<Node const*> reaching { sub };
+	for (auto const& from : supers)
+		if (from.first != sub && _isA(supers, from.first, sub))
+			reaching.push_back(from.first);
+
+	for (auto n : reaching)
+	{
+		auto& to = supers[n];
+		for (auto r : reached)
+			if (std::find(to.begin(), to.end(), r) == to.end())
+				to.push_back(r);
+	}
+}
+
+DispatchCache& TypeOverlay::dispatchCache(Node const* dispatcher)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	auto& cache = _dispatchCaches[dispatcher];
+	if (!cache)
+	{
+		cache.reset(new DispatchCache());
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+		cache->statsIndex = details::dispatch_stats_register(TypeId(dispatcher));
+#endif
+	}
+	return *cache;
+}
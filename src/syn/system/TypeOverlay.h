@@ -0,0 +1,75 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	class DispatchCache;
+
+	/******************************************************************************
+	** TypeOverlay
+	******************************************************************************/
+
+	/* What a `TypeStore` made as an overlay of another (see `TypeStore(TypeStore const*)`) keeps
+	 * about it's base, which it only ever reads.
+	 *
+	 * The overlay's graph holds only what was added to it, with a shadow node standing in for
+	 * each base node it added edges or props to. This tracks which elements are the overlay's own,
+	 * the shadows both ways, the `EIsA` closure layered over the base's and the dispatch caches
+	 * of the overlay (the base keeps it's own on the dispatcher nodes). The store makes the
+	 * shadows and adds everything to it's graph, under it's write lock.
+	 *
+	 * Guarded by a lock of it's own, held only for a lookup (or to publish an update) and never
+	 * while calling back into the store, so readers of an overlay don't take the store's write
+	 * lock.
+	 */
+	class TypeOverlay final
+	{
+	private:
+		TypeStore const& _base;
+
+		mutable std::mutex _lock;
+
+		std::unordered_set<void const*> _owned;
+		std::unordered_map<Graph::Node const*, Graph::Node*> _shadows;
+		std::unordered_map<Graph::Node const*, Graph::Node const*> _canonical;
+		std::unordered_map<Graph::Node const*, std::unique_ptr<DispatchCache>> _dispatchCaches;
+
+		// Each node with an `EIsA` edge of the overlay's own, with every super reached by a path
+		// from it through the overlay's edges (and the base's closure between them). Kept up to
+		// date by `addIsA`, so `isA` need not search.
+		using _Supers = std::unordered_map<Graph::Node const*, std::vector<Graph::Node const*>>;
+		_Supers _supers;
+
+		bool _isA(_Supers const& supers, Graph::Node const* sub, Graph::Node const* super) const;
+		void _addIsA(_Supers& supers, Graph::Node const* sub, Graph::Node const* super) const;
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED explicit TypeOverlay(TypeStore const& base);
+		CULTLANG_SYNDICATE_EXPORTED ~TypeOverlay();
+
+		TypeOverlay(TypeOverlay const&) = delete;
+		TypeOverlay& operator=(TypeOverlay const&) = delete;
+
+		inline TypeStore const& base() const { return _base; }
+
+		// Nodes and edges added to the overlay's graph, other than shadows.
+		CULTLANG_SYNDICATE_EXPORTED void own(void const* element);
+		CULTLANG_SYNDICATE_EXPORTED bool owns(void const* element) const;
+
+		// The shadow standing in for base node `node`, or null if the overlay has none yet.
+		CULTLANG_SYNDICATE_EXPORTED Graph::Node* shadowOf(Graph::Node const* node) const;
+		CULTLANG_SYNDICATE_EXPORTED void addShadow(Graph::Node const* node, Graph::Node* shadow);
+
+		// The node `node` stands in for, if it is a shadow (of this overlay or below).
+		CULTLANG_SYNDICATE_EXPORTED Graph::Node const* canonical(Graph::Node const* node) const;
+
+		// The base's closure joined with the overlay's own `EIsA` edges, by canonical nodes.
+		CULTLANG_SYNDICATE_EXPORTED bool isA(Graph::Node const* sub, Graph::Node const* super) const;
+		CULTLANG_SYNDICATE_EXPORTED void addIsA(Graph::Node const* sub, Graph::Node const* super);
+		// Replaces the overlay's closure with that of `edges`, built aside so `isA` sees the old
+		// one or the new one.
+		CULTLANG_SYNDICATE_EXPORTED void resetIsA(std::vector<std::pair<Graph::Node const*, Graph::Node const*>> const& edges);
+
+		CULTLANG_SYNDICATE_EXPORTED DispatchCache& dispatchCache(Graph::Node const* dispatcher);
+	};
+}
@@ -4,22 +4,431 @@
 using namespace syn;
 
 using Node = Graph::Node;
+using Edge = Graph::Edge;
+
+namespace
+{
+	thread_local void const* current_source = nullptr;
+	thread_local TypeStore* current_store = nullptr;
+
+	// Overlay revisions start apart, see `TypeStore::revision`
+	std::atomic<uint64_t> overlay_count { 0 };
+}
 
 /******************************************************************************
 ** Graph
 ******************************************************************************/
 
 TypeStore::TypeStore()
+	: TypeStore(nullptr)
+{ }
+TypeStore::TypeStore(TypeStore const* base)
+	: _ownSymbols(base == nullptr ? new SymbolTable() : nullptr)
+	// Interning is safe alongside the base's readers (see `SymbolTable`), and leaves it's graph be
+	, _symbols(base == nullptr ? _ownSymbols.get() : const_cast<SymbolTable*>(&base->s()))
+	, _subtypes(new SubtypeIndex())
+	, _overlay(base != nullptr ? new TypeOverlay(*base) : nullptr)
+	, _origin(base != nullptr ? (overlay_count.fetch_add(1) + 1) << 32 : 0)
+	, _revision(_origin)
+	, _subtypeRevision(0)
+	, _subtypeDispatchRevision(0)
+	, _specializerRevision(0)
+	, _frozen(nullptr)
+	, _typeStripeBits(base != nullptr ? 4 : 8)
+	, _nodeStripeBits(base != nullptr ? 6 : 12)
+	, _typeRevisions(new std::atomic<uint64_t>[size_t(1) << _typeStripeBits])
+	, _nodeRevisions(new std::atomic<uint64_t>[size_t(1) << _nodeStripeBits])
+	, _deferredStripes(nullptr)
+	, _replacing(0)
 {
-
+	for (size_t i = 0; i < (size_t(1) << _typeStripeBits); ++i)
+		_typeRevisions[i].store(0, std::memory_order_relaxed);
+	for (size_t i = 0; i < (size_t(1) << _nodeStripeBits); ++i)
+		_nodeRevisions[i].store(0, std::memory_order_relaxed);
 }
 TypeStore::~TypeStore()
 {
+	delete _frozen.load(std::memory_order_acquire);
+	delete _subtypes.load(std::memory_order_acquire);
+	delete[] _deferredStripes.load(std::memory_order_acquire);
+
+	// Dispatch caches are made on demand into the dispatcher's node, which the graph doesn't free
+	auto dispatcher = type<core::NDispatcher>::graphNode();
+	_graph.forAllNodes([&](Node const* n)
+	{
+		if (n->type.node == dispatcher)
+			delete DispatchCache::on(n).exchange(nullptr, std::memory_order_acq_rel);
+	});
+}
+
+Graph::Edge* TypeStore::addIsA(Node* sub, Node* super)
+{
+	// The subtype index must agree with the edge before anyone sees the new revision
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	bool related = isA(sub, super);
+	PayloadArena::Scope scope(_payloads);
+	auto e = _graph.addEdge<core::EIsA>({ }, { _local(sub), _local(super) });
+	_subtypes.load(std::memory_order_relaxed)->addIsA(sub, super);
+	if (_overlay != nullptr)
+		_overlay->addIsA(sub, super);
+	_isA.push_back(e);
+	_edgesOfType.require(type<core::EIsA>::graphNode()).push_back(e);
+	_addEdgeOnNodes(e);
+	if (_overlay != nullptr)
+		_overlay->own(e);
+	if (auto added = _added())
+		added->edges.push_back(e);
+	if (!related)
+	{
+		_subtypeRevision.fetch_add(1, std::memory_order_release);
+		_subtypeDispatchRevision.fetch_add(1, std::memory_order_release);
+	}
+	_bump(type<core::EIsA>::graphNode(), { sub, super });
+	return e;
+}
+
+Graph::Edge* TypeStore::addMethod(Node* dispatcher, Node* function)
+{
+	return addEdge<core::EUsingDispatcherFunction>({ }, dispatcher, function);
+}
+
+Graph::Node* TypeStore::addValueSpecializer(Node* function, size_t argument, TypeId type, uint64_t key)
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	auto n = addNode<core::NValueSpecializer>({ argument, type, key });
+	addEdge<core::ESpecializesArgument>({ }, function, n);
+	_specializerRevision.fetch_add(1, std::memory_order_release);
+	return n;
+}
 
+void TypeStore::defer(Node const* node, void (*definer)(void*), void* context)
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	if (!_deferred.emplace(node, _Deferred { definer, context, Source::current() }).second)
+		throw stdext::exception("Node {0} already has a deferred definition.", TypeId(node));
+
+	if (_deferredStripes.load(std::memory_order_relaxed) == nullptr)
+	{
+		auto stripes = new std::atomic<uint32_t>[size_t(1) << _nodeStripeBits];
+		for (size_t i = 0; i < (size_t(1) << _nodeStripeBits); ++i)
+			stripes[i].store(0, std::memory_order_relaxed);
+		_deferredStripes.store(stripes, std::memory_order_release);
+	}
+	_deferredStripe(node).fetch_add(1, std::memory_order_release);
+}
+
+void TypeStore::_require(Node const* node) const
+{
+	// Definitions change the store through it's (recursive) write lock, holding it here makes
+	// other threads requiring this node wait for the definition to finish
+	std::lock_guard<std::recursive_mutex> lock(_write);
+
+	auto it = _deferred.find(node);
+	if (it == _deferred.end())
+		return;
+
+	// Removed first, so a definition requiring it's own node does not recurse
+	auto deferred = it->second;
+	_deferred.erase(it);
+
+	struct Done
+	{
+		std::atomic<uint32_t>& stripe;
+		~Done() { stripe.fetch_sub(1, std::memory_order_release); }
+	} done { _deferredStripe(node) };
+
+	deferred.definer(deferred.context);
+
+	// The definition adds this node's `EIsA` edges, `is_a` through it needs the supers' as well
+	static QueryPlan const supers_plan = QueryPlan().out(type<core::EIsA>::id());
+
+	// Requiring a super may run definitions adding more, so the results are not reused meanwhile
+	QueryPlan::Scratch supers;
+	supers_plan.run(*this, node, supers);
+	for (auto super : supers.results())
+		require(super);
+}
+
+void TypeStore::requireAll()
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	while (!_deferred.empty())
+		_require(_deferred.begin()->first);
+}
+
+size_t TypeStore::deferredCount() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	return _deferred.size();
+}
+
+void TypeStore::freeze()
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	if (_overlay != nullptr)
+		throw stdext::exception("An overlay can not be frozen, freeze it's base.");
+	if (frozen() != nullptr)
+		return;
+
+	auto previous = _frozen.exchange(new FrozenGraph(_graph, subtypes(), _revision.load(std::memory_order_acquire)), std::memory_order_acq_rel);
+	if (previous != nullptr)
+		Epoch::retire(const_cast<FrozenGraph*>(previous));
+}
+
+void TypeStore::thaw()
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	auto previous = _frozen.exchange(nullptr, std::memory_order_acq_rel);
+	if (previous != nullptr)
+		Epoch::retire(const_cast<FrozenGraph*>(previous));
+}
+
+/******************************************************************************
+** TypeStore retirement
+******************************************************************************/
+
+TypeStore::Source::Source(void const* source)
+	: _previous(current_source)
+{
+	current_source = source;
+}
+
+TypeStore::Source::~Source()
+{
+	current_source = _previous;
+}
+
+void const* TypeStore::Source::current()
+{
+	return current_source;
+}
+
+void TypeStore::retire(void const* source)
+{
+	Replacement replacement(*this);
+	std::lock_guard<std::recursive_mutex> lock(_write);
+
+	for (auto it = _deferred.begin(); it != _deferred.end(); )
+	{
+		if (it->second.source != source)
+		{
+			++it;
+			continue;
+		}
+
+		_deferredStripe(it->first).fetch_sub(1, std::memory_order_release);
+		it = _deferred.erase(it);
+	}
+
+	auto it = _sources.find(source);
+	if (it == _sources.end())
+		return;
+
+	auto added = std::move(it->second);
+	_sources.erase(it);
+
+	// Props the source's replacement already added (on nodes it kept) are newer, and stay indexed
+	for (auto const& prop : added.props)
+	{
+		auto indexed = _props.find({ prop.node, prop.type });
+		if (indexed != nullptr && indexed->load(std::memory_order_relaxed) == prop.payload)
+		{
+			indexed->store(nullptr, std::memory_order_release);
+			_nodesWithProp.require(prop.type).removeIf([&](Node const* n) { return n == prop.node; });
+		}
+		_bump(prop.type, { prop.node });
+	}
+
+	for (auto e : added.edges)
+		_retireEdge(e);
+	for (auto n : added.nodes)
+		_retireNode(n);
+}
+
+void TypeStore::retireNode(Node const* node)
+{
+	Replacement replacement(*this);
+	std::lock_guard<std::recursive_mutex> lock(_write);
+
+	auto deferred = _deferred.find(node);
+	if (deferred != _deferred.end())
+	{
+		_deferredStripe(node).fetch_sub(1, std::memory_order_release);
+		_deferred.erase(deferred);
+	}
+
+	_retireNode(node);
+}
+
+void TypeStore::_retireNode(Node const* node)
+{
+	if (!_retired.insert(node).second)
+		return;
+
+	// Only edges of this store, an overlay can't retire those of it's base
+	std::vector<Edge const*> edges;
+	auto shadow = _overlay != nullptr ? _overlay->shadowOf(node) : nullptr;
+	_graph.forAllEdgesOnNode(shadow != nullptr ? shadow : node, [&](auto e) { edges.push_back(e); });
+	for (auto e : edges)
+		_retireEdge(e);
+
+	_bump(node->type.node, { node });
+}
+
+void TypeStore::_retireEdge(Edge const* edge)
+{
+	if (!_retired.insert(edge).second)
+		return;
+
+	if (TypeId(edge->type) == type<core::EIsA>::id() && edge->nodes.size() == 2)
+		_retiredIsA.push_back({ canonical((Node const*)edge->nodes[0]), canonical((Node const*)edge->nodes[1]) });
+	if (TypeId(edge->type) == type<core::ESpecializesArgument>::id())
+		_specializerRevision.fetch_add(1, std::memory_order_release);
+
+	for (auto n : edge->nodes)
+		_nodeStripe(canonical((Node const*)n)).fetch_add(1, std::memory_order_release);
+	_bump(edge->type.node, { });
+}
+
+void TypeStore::_settle()
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	if (_replacing != 0 || _retiredIsA.empty())
+		return;
+
+	_isA.erase(std::remove_if(_isA.begin(), _isA.end(), [&](Edge const* e) { return isRetired(e); }), _isA.end());
+
+	std::set<std::pair<Node const*, Node const*>> live;
+	for (auto e : _isA)
+		live.insert({ canonical((Node const*)e->nodes[0]), canonical((Node const*)e->nodes[1]) });
+
+	std::set<std::pair<Node const*, Node const*>> stale;
+	for (auto const& pair : _retiredIsA)
+		if (live.count(pair) == 0)
+			stale.insert(pair);
+	_retiredIsA.clear();
+
+	if (stale.empty())
+		return;
+
+	if (_overlay == nullptr)
+	{
+		// Only the subs and their descendants lose supers, only dispatchers on those supers change
+		std::unordered_set<Node const*> lost;
+		auto& subtypes = *_subtypes.load(std::memory_order_relaxed);
+		for (auto const& pair : stale)
+			subtypes.removeIsA(pair.first, pair.second, [&](Node const* n) { lost.insert(n); });
+		if (lost.empty())
+			return;
+
+		_subtypeRevision.fetch_add(1, std::memory_order_release);
+		_moveDispatchersOn(lost);
+		_bump(type<core::EIsA>::graphNode(), { });
+		return;
+	}
+
+	// An overlay's closure is layered over the base's, so it is rebuilt aside (readers keep using
+	// the old one meanwhile) and moves every dispatcher
+	auto rebuilt = new SubtypeIndex();
+	std::vector<std::pair<Node const*, Node const*>> edges;
+	for (auto e : _isA)
+	{
+		edges.push_back({ canonical((Node const*)e->nodes[0]), canonical((Node const*)e->nodes[1]) });
+		rebuilt->addIsA(edges.back().first, edges.back().second);
+	}
+	_overlay->resetIsA(edges);
+	Epoch::retire(_subtypes.exchange(rebuilt, std::memory_order_acq_rel));
+	_subtypeRevision.fetch_add(1, std::memory_order_release);
+	_subtypeDispatchRevision.fetch_add(1, std::memory_order_release);
+	_bump(type<core::EIsA>::graphNode(), { });
+}
+
+void TypeStore::_moveDispatchersOn(std::unordered_set<Node const*> const& types)
+{
+	auto on = [&](TypeId type) { return types.count((Node const*)type) != 0; };
+	auto methods = type<core::EUsingDispatcherFunction>::graphNode();
+	auto specializes = type<core::ESpecializesArgument>::graphNode();
+
+	// A dispatch only asks if it's arguments are-a the types it's methods (and their value
+	// specializers) are on, without running definitions deferred (those move it when they run)
+	Epoch::Guard guard;
+	forAllNodesOfType<core::NDispatcher>([&](Node const* dispatcher)
+	{
+		bool depends = false;
+		forAllEdgesOfTypeOnNode(dispatcher, methods, [&](Edge const* method)
+		{
+			auto function = (Node const*)method->nodes[1];
+			if (depends || isRetired(method) || function == dispatcher)
+				return;
+
+			if (auto args = reinterpret_cast<core::PDispatchArguments*>(_findProp(function, type<core::PDispatchArguments>::graphNode())))
+				for (auto t : args->types)
+					depends |= on(t);
+
+			forAllEdgesOfTypeOnNode(function, specializes, [&](Edge const* e)
+			{
+				if ((Node const*)e->nodes[0] == function && !isRetired(e))
+					depends |= on(GraphConfig::typed_load<core::NValueSpecializer>(((Node const*)e->nodes[1])->data)->type);
+			});
+		});
+
+		if (depends)
+			_nodeStripe(dispatcher).fetch_add(1, std::memory_order_release);
+	});
+}
+
+/******************************************************************************
+** TypeStore overlays
+******************************************************************************/
+
+TypeStore::Scope::Scope(TypeStore& store)
+	: _previous(current_store)
+{
+	current_store = &store;
+}
+
+TypeStore::Scope::~Scope()
+{
+	current_store = _previous;
+}
+
+TypeStore* TypeStore::Scope::current()
+{
+	return current_store;
+}
+
+Node* TypeStore::_shadow(Node* node)
+{
+	std::lock_guard<std::recursive_mutex> lock(_write);
+	if (_overlay->owns(node))
+		return node;
+	if (auto shadow = _overlay->shadowOf(node))
+		return shadow;
+
+	// Not recorded under a source or bumped, it is only where this store keeps the base node's delta
+	PayloadArena::Scope scope(_payloads);
+	auto shadow = const_cast<Node*>(_graph.addNode<core::NAbstract>({ }));
+	_overlay->addShadow(node, shadow);
+	return shadow;
+}
+
+uint64_t TypeStore::dispatchRevision(Node const* dispatcher) const
+{
+	// Each only grows, so their sum moves whenever one does
+	auto own = nodeRevision(dispatcher).load() + _subtypeDispatchRevision.load(std::memory_order_acquire)
+		+ _specializerRevision.load(std::memory_order_acquire);
+	if (_overlay == nullptr)
+		return own;
+
+	// Apart from the base's and other overlays', as `revision`
+	return _origin + own + _overlay->base().dispatchRevision(dispatcher);
 }
 
 std::string TypeStore::describeNode(Node const* n)
 {
+	require(n);
+	std::lock_guard<std::recursive_mutex> lock(_write);
+
 	std::ostringstream ss;
 	//Node const* nt = (Node const*)n->type.node;
 
@@ -10,8 +10,214 @@ namespace syn
 	class TypeStore final
 	{
 	private:
+		// Declared first so it outlives everything pointing into it
+		PayloadArena _payloads;
+
 		Graph _graph;
-		SymbolTable _symbols;
+		// Overlays have none of their own, and use their base's (see `s`)
+		std::unique_ptr<SymbolTable> _ownSymbols;
+		SymbolTable* _symbols;
+
+		// An overlay's is replaced whole when a retirement makes it forget an edge (see `_settle`),
+		// the previous one is retired through `Epoch`.
+		std::atomic<SubtypeIndex*> _subtypes;
+
+		// What this store keeps about the store it is an overlay of (see `TypeStore(TypeStore const*)`),
+		// or null.
+		std::unique_ptr<TypeOverlay> _overlay;
+
+		CULTLANG_SYNDICATE_EXPORTED Graph::Node* _shadow(Graph::Node* node);
+
+		// The node standing in for `node` in this store's graph.
+		inline Graph::Node* _local(Graph::Node* node)
+		{
+			return _overlay == nullptr ? node : _shadow(node);
+		}
+
+		// Held by every change made through the store, so initers and lazy definitions may run in
+		// parallel with each other. Reads don't take it: the subtype index, the prop hash and the
+		// indexes below are lock free (see `LockFreeIndex.h`), and the graph itself is only read by
+		// writers, an overlay's bookkeeping has a lock of it's own (see `TypeOverlay`). Recursive,
+		// a read's callback may change the store.
+		mutable std::recursive_mutex _write;
+
+		// Where this store's revisions start, overlays start apart from each other (see `revision`).
+		uint64_t _origin;
+
+		// Bumped by every change made through the store, read without locks (e.g. by dispatch).
+		std::atomic<uint64_t> _revision;
+
+		// Bumped whenever the subtype closure changes, rather than for every `EIsA` edge, and
+		// whenever a value specializer is added or retired (see `dispatchRevision`). Not striped,
+		// so no other change moves them. Dispatch only follows the closure growing (and an
+		// overlay's changing) through `_subtypeDispatchRevision`, when a base store's shrinks
+		// `_settle` moves the dispatchers with methods on the types lost instead.
+		std::atomic<uint64_t> _subtypeRevision;
+		std::atomic<uint64_t> _subtypeDispatchRevision;
+		std::atomic<uint64_t> _specializerRevision;
+
+		// See `freeze`, only used while it's revision is the store's. Replaced copies are retired
+		// through `Epoch`, readers hold a guard while they use one.
+		std::atomic<FrozenGraph const*> _frozen;
+
+		// Per element type and per node revisions are striped by pointer, two things sharing a
+		// stripe only ever cause a spurious invalidation. Sized by the store, an overlay (holding
+		// a small delta) has far fewer than a base.
+		size_t const _typeStripeBits;
+		size_t const _nodeStripeBits;
+		std::unique_ptr<std::atomic<uint64_t>[]> _typeRevisions;
+		std::unique_ptr<std::atomic<uint64_t>[]> _nodeRevisions;
+
+		inline static size_t _stripe(void const* ptr, size_t bits)
+		{
+			return (size_t)(((uint64_t)(uintptr_t)ptr * 0x9e3779b97f4a7c15ull) >> (64 - bits));
+		}
+		inline std::atomic<uint64_t>& _typeStripe(void const* type) const { return _typeRevisions[_stripe(type, _typeStripeBits)]; }
+		inline std::atomic<uint64_t>& _nodeStripe(Graph::Node const* node) const { return _nodeRevisions[_stripe(node, _nodeStripeBits)]; }
+
+		// Definitions not run yet (see `defer`), guarded by `_write`. Each node stripe counts it's
+		// deferred nodes, until their definitions (and their supers') finish, so `require` can skip
+		// the lock for nodes with nothing deferred. The stripes are made by the first `defer`,
+		// until then nothing is deferred.
+		struct _Deferred
+		{
+			void (*definer)(void*);
+			void* context;
+			void const* source;
+		};
+		mutable std::unordered_map<Graph::Node const*, _Deferred> _deferred;
+		std::atomic<std::atomic<uint32_t>*> _deferredStripes;
+
+		// Under `_write`, once there are stripes.
+		inline std::atomic<uint32_t>& _deferredStripe(Graph::Node const* node) const
+		{
+			return _deferredStripes.load(std::memory_order_relaxed)[_stripe(node, _nodeStripeBits)];
+		}
+
+		CULTLANG_SYNDICATE_EXPORTED void _require(Graph::Node const*) const;
+
+		// Records a change to an element of type `type` touching `nodes`, after the change is made.
+		inline void _bump(void const* type, std::initializer_list<Graph::Node const*> nodes)
+		{
+			_typeStripe(type).fetch_add(1, std::memory_order_release);
+			for (auto n : nodes)
+				_nodeStripe(n).fetch_add(1, std::memory_order_release);
+			_revision.fetch_add(1, std::memory_order_release);
+		}
+
+		// The prop of each type on each node, kept by `addProp` so lookups need not scan the node.
+		struct _PropKey
+		{
+			Graph::Node const* node;
+			void const* type;
+
+			inline bool operator==(_PropKey const& that) const { return node == that.node && type == that.type; }
+		};
+		struct _PropKeyHash
+		{
+			inline size_t operator()(_PropKey const& key) const
+			{
+				auto h = std::hash<void const*>()(key.node);
+				return h ^ (std::hash<void const*>()(key.type) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+			}
+		};
+		// Retiring a prop clears it's value rather than the entry.
+		LockFreeMap<_PropKey, std::atomic<void*>, _PropKeyHash> _props;
+
+		// Under an `Epoch::Guard`.
+		inline void* _findProp(Graph::Node const* node, void const* type) const
+		{
+			auto prop = _props.find({ node, type });
+			return prop != nullptr ? prop->load(std::memory_order_acquire) : nullptr;
+		}
+
+		// Everything added through the store by type (the type's graph node), so enumerating the
+		// elements of a type costs what there are of it rather than the size of the graph. Props
+		// are by the nodes carrying them, once each whatever the number of props.
+		template<typename TElement>
+		using _Index = LockFreeMap<void const*, LockFreeList<TElement const*>>;
+		_Index<Graph::Node> _nodesOfType;
+		_Index<Graph::Edge> _edgesOfType;
+		_Index<Graph::Node> _nodesWithProp;
+
+		// The edges and props on each node of this store's graph (an overlay's shadows rather than
+		// the base nodes), in the order they were added. The graph's own adjacency can't be read
+		// while it changes.
+		LockFreeMap<Graph::Node const*, LockFreeList<Graph::Edge const*>> _edgesOnNode;
+		LockFreeMap<Graph::Node const*, LockFreeList<Graph::Prop const*>> _propsOnNode;
+
+		// Indexes `edge` on each of it's nodes, once.
+		inline void _addEdgeOnNodes(Graph::Edge const* edge)
+		{
+			for (size_t i = 0; i < edge->nodes.size(); ++i)
+				if (std::find(edge->nodes.begin(), edge->nodes.begin() + i, edge->nodes[i]) == edge->nodes.begin() + i)
+					_edgesOnNode.require((Graph::Node const*)edge->nodes[i]).push_back(edge);
+		}
+
+		template<typename F>
+		inline void _forAllEdgesOnLocal(Graph::Node const* local, F const& f) const
+		{
+			Epoch::Guard guard;
+			if (auto edges = _edgesOnNode.find(local))
+				edges->forEach(f);
+		}
+		template<typename F>
+		inline void _forAllPropsOnLocal(Graph::Node const* local, F const& f) const
+		{
+			Epoch::Guard guard;
+			if (auto props = _propsOnNode.find(local))
+				props->forEach(f);
+		}
+
+		// The nodes with a prop of `type` from this store down, skipping those `top` (or a store
+		// between) has it's own prop of the type on.
+		template<typename F>
+		inline void _forAllNodesWithProp(void const* type, TypeStore const* top, F const& f) const;
+
+		// By index, `f` may add more of the type while it runs.
+		template<typename TElement, typename F>
+		inline void _forAllOfType(_Index<TElement> const& index, void const* type, F const& f) const
+		{
+			Epoch::Guard guard;
+			auto elements = index.find(type);
+			if (elements == nullptr)
+				return;
+
+			elements->forEach([&](TElement const* element)
+			{
+				if (!isRetired(element))
+					f(element);
+			});
+		}
+
+		// What was added under each `Source`, until it is retired. Retired nodes and edges stay in
+		// the graph (it can't remove them), but store lookups and dispatch skip them.
+		struct _AddedProp
+		{
+			Graph::Node const* node;
+			void const* type;
+			void* payload;
+		};
+		struct _Added
+		{
+			std::vector<Graph::Node const*> nodes;
+			std::vector<Graph::Edge const*> edges;
+			std::vector<_AddedProp> props;
+		};
+		std::unordered_map<void const*, _Added> _sources;
+		std::unordered_set<void const*> _retired;
+
+		// Every `EIsA` edge, and the pairs retired since the subtype index was last settled. See
+		// `Replacement`, while one is open the index is only settled once it closes.
+		std::vector<Graph::Edge const*> _isA;
+		std::vector<std::pair<Graph::Node const*, Graph::Node const*>> _retiredIsA;
+		size_t _replacing;
+
+		inline _Added* _added();
+		void _retireNode(Graph::Node const*);
+		void _retireEdge(Graph::Edge const*);
+		CULTLANG_SYNDICATE_EXPORTED void _settle();
+		void _moveDispatchersOn(std::unordered_set<Graph::Node const*> const& types);
 
 		// 
 		// Lifecycle
@@ -23,12 +229,458 @@ namespace syn
 		CULTLANG_SYNDICATE_EXPORTED TypeStore();
 		CULTLANG_SYNDICATE_EXPORTED ~TypeStore();
 
+		// An overlay of `base`, e.g. for a session's speculative definitions. Lookups, `isA` and
+		// dispatch through it see it's own additions over everything in `base`, while changes only
+		// go to the overlay, under it's own lock; `base` is only read. It must outlive the overlay
+		// and should not change meanwhile. Discarding the overlay costs only what was added to it.
+		CULTLANG_SYNDICATE_EXPORTED explicit TypeStore(TypeStore const* base);
+
+		// The store this one is an overlay of, or null.
+		inline TypeStore const* base() const { return _overlay != nullptr ? &_overlay->base() : nullptr; }
+		inline TypeOverlay* overlay() const { return _overlay.get(); }
+
+		// Makes `store` the `thread_store()` of this thread while it is open. Nests.
+		class Scope final
+		{
+		private:
+			TypeStore* _previous;
+
+		public:
+			CULTLANG_SYNDICATE_EXPORTED Scope(TypeStore& store);
+			CULTLANG_SYNDICATE_EXPORTED ~Scope();
+
+			Scope(Scope const&) = delete;
+			Scope& operator=(Scope const&) = delete;
+
+			CULTLANG_SYNDICATE_EXPORTED static TypeStore* current();
+		};
+
+		// Only what was added to this store, for an overlay.
 		inline Graph& g() { return _graph; }
 		inline Graph const& g() const { return _graph; }
 
-		inline SymbolTable& s() { return _symbols; }
-		inline SymbolTable const& s() const { return _symbols; }
+		// Overlays share the symbols of their base.
+		inline SymbolTable& s() { return *_symbols; }
+		inline SymbolTable const& s() const { return *_symbols; }
+
+		// Only the `EIsA` edges added to this store, use `isA` to include an overlay's base. It's
+		// `isA` and `indexOf` are lock free, hold `lockWrites` while reading the rest if the store
+		// may change meanwhile.
+		inline SubtypeIndex const& subtypes() const { return *_subtypes.load(std::memory_order_acquire); }
+
+		inline bool isA(Graph::Node const* sub, Graph::Node const* super) const
+		{
+			if (_overlay != nullptr)
+				return _overlay->isA(sub, super);
+
+			Epoch::Guard guard;
+			if (auto frozen = this->frozen())
+				return frozen->isA(sub, super);
+			return _subtypes.load(std::memory_order_acquire)->isA(sub, super);
+		}
+
+		// The node `node` stands in for, if it is an overlay's shadow of a base node.
+		inline Graph::Node const* canonical(Graph::Node const* node) const
+		{
+			return _overlay == nullptr ? node : _overlay->canonical(node);
+		}
+
+		// Every edge on `node`, in an overlay those of the base as well. Edges of an overlay hold
+		// shadows, compare their nodes through `canonical`.
+		template<typename F>
+		inline void forAllEdgesOnNode(Graph::Node const* node, F const& f) const
+		{
+			if (_overlay == nullptr)
+			{
+				Epoch::Guard guard;
+				if (auto frozen = this->frozen())
+					frozen->forAllEdgesOnNode(node, f);
+				else
+					_forAllEdgesOnLocal(node, f);
+				return;
+			}
+
+			if (_overlay->owns(node))
+			{
+				_forAllEdgesOnLocal(node, f);
+				return;
+			}
+
+			_overlay->base().forAllEdgesOnNode(node, f);
+			if (auto shadow = _overlay->shadowOf(node))
+				_forAllEdgesOnLocal(shadow, f);
+		}
+
+		// The edges of type `type` on `node`, as `forAllEdgesOnNode`. Only looks at those once frozen.
+		template<typename F>
+		inline void forAllEdgesOfTypeOnNode(Graph::Node const* node, void const* type, F const& f) const
+		{
+			if (_overlay == nullptr)
+			{
+				Epoch::Guard guard;
+				if (auto frozen = this->frozen())
+				{
+					frozen->forAllEdgesOfTypeOnNode(node, type, f);
+					return;
+				}
+			}
+
+			forAllEdgesOnNode(node, [&](auto e)
+			{
+				if (e->type.node == type)
+					f(e);
+			});
+		}
+
+		// Every prop on `node`, as the graph's `forAllPropsOnNode`, in an overlay those of the base
+		// first.
+		template<typename F>
+		inline void forAllPropsOnNode(Graph::Node const* node, F const& f) const
+		{
+			if (_overlay == nullptr)
+			{
+				Epoch::Guard guard;
+				if (auto frozen = this->frozen())
+					frozen->forAllPropsOnNode(node, f);
+				else
+					_forAllPropsOnLocal(node, f);
+				return;
+			}
+
+			if (!_overlay->owns(node))
+			{
+				_overlay->base().forAllPropsOnNode(node, f);
+				node = _overlay->shadowOf(node);
+				if (node == nullptr)
+					return;
+			}
+			_forAllPropsOnLocal(node, f);
+		}
+
+		// Compacts the graph (and the subtype index) into a `FrozenGraph`, which then serves
+		// `forAllEdgesOnNode`, `forAllEdgesOfTypeOnNode`, `forAllPropsOnNode` and `isA` until the
+		// store next changes. Any change thaws it: lookups go back to the store's indexes, and the
+		// copy is kept until `thaw` or the next `freeze`. Meant for after boot, when the graph is
+		// read for long stretches, changes in an overlay leave the base frozen. Safe alongside
+		// readers, the copy replaced (or dropped by `thaw`) is retired through `Epoch`. Throws for
+		// an overlay.
+		CULTLANG_SYNDICATE_EXPORTED void freeze();
+		// Drops the frozen copy.
+		CULTLANG_SYNDICATE_EXPORTED void thaw();
+
+		// The frozen copy, if there is one and nothing changed since it was made. Hold an
+		// `Epoch::Guard` for as long as it is used, `freeze` and `thaw` may retire it meanwhile.
+		inline FrozenGraph const* frozen() const
+		{
+			auto frozen = _frozen.load(std::memory_order_acquire);
+			return frozen != nullptr && frozen->revision() == _revision.load(std::memory_order_acquire) ? frozen : nullptr;
+		}
+
+		// Changes made through the store take this lock, take it to change the graph directly.
+		inline std::unique_lock<std::recursive_mutex> lockWrites() const { return std::unique_lock<std::recursive_mutex>(_write); }
+
+		// Where the boxed payloads of everything added through the store live.
+		inline PayloadArena const& payloads() const { return _payloads; }
+
+		inline uint64_t revision() const
+		{
+			auto own = _revision.load(std::memory_order_acquire);
+			if (_overlay == nullptr)
+				return own;
+
+			// Grows with either, caches only keep newer results. The overlay's own starts far enough
+			// apart that it never equals a base's or another overlay's, since caches keyed by it may
+			// be shared between stores.
+			return own + _overlay->base().revision();
+		}
+
+		// A revision counter derived data can depend on (see `syn::Cached`), read it before reading
+		// the graph.
+		struct Revision
+		{
+			std::atomic<uint64_t> const* counter;
+
+			inline uint64_t load() const { return counter->load(std::memory_order_acquire); }
+		};
+
+		// Moves on every change (to this store, not an overlay's base).
+		inline Revision globalRevision() const { return { &_revision }; }
+		// Moves whenever a node, edge or prop of type `type` is added.
+		inline Revision typeRevision(void const* type) const { return { &_typeStripe(type) }; }
+		template<typename T>
+		inline Revision typeRevision() const { return typeRevision(GraphConfig::typed_typeToValue<T>().node); }
+		// Moves whenever an edge or prop touching `node` is added.
+		inline Revision nodeRevision(Graph::Node const* node) const { return { &_nodeStripe(node) }; }
+		// Moves whenever `isA` changes for some pair, an `EIsA` edge between types already related does not move it.
+		inline Revision subtypeRevision() const { return { &_subtypeRevision }; }
+
+		// What dispatching on `dispatcher` depends on: the edges on it (it's methods), the subtype
+		// closure and value specializers. Changes elsewhere (e.g. a deferred definition adding
+		// another dispatcher's methods, or retiring an `EIsA` edge between types none of it's
+		// methods are on) leave it, so caches keyed by it survive them. Never decreases.
+		CULTLANG_SYNDICATE_EXPORTED uint64_t dispatchRevision(Graph::Node const* dispatcher) const;
+
+		// Attributes the changes made on this thread while it is open to `source` (e.g. a define),
+		// so they can be retired together, see `retire`. Nests.
+		class Source final
+		{
+		private:
+			void const* _previous;
+
+		public:
+			CULTLANG_SYNDICATE_EXPORTED Source(void const* source);
+			CULTLANG_SYNDICATE_EXPORTED ~Source();
+
+			Source(Source const&) = delete;
+			Source& operator=(Source const&) = delete;
+
+			CULTLANG_SYNDICATE_EXPORTED static void const* current();
+		};
+
+		// Retirements made while one is open are settled when the outermost closes, so a source
+		// retired and then replaced costs no subtype rebuild if the replacement adds the same
+		// `EIsA` edges. Does not hold the write lock, initers may run on other threads meanwhile.
+		class Replacement final
+		{
+		private:
+			TypeStore& _store;
+
+		public:
+			inline Replacement(TypeStore& store)
+				: _store(store)
+			{
+				std::lock_guard<std::recursive_mutex> lock(_store._write);
+				_store._replacing += 1;
+			}
+			inline ~Replacement()
+			{
+				{
+					std::lock_guard<std::recursive_mutex> lock(_store._write);
+					_store._replacing -= 1;
+				}
+				_store._settle();
+			}
+
+			Replacement(Replacement const&) = delete;
+			Replacement& operator=(Replacement const&) = delete;
+		};
+
+		// Retires everything added under `source` (nodes, edges, indexed props, and definitions
+		// deferred but not yet run). Retired nodes and edges are skipped by dispatch, their props
+		// are no longer found, and the subtype index forgets retired `EIsA` edges (recomputing the
+		// closure below the sub, only when no live edge still makes the same pair). Bumps the
+		// revisions of everything retired. Not synchronized with readers, callers must be at a quiescent point.
+		CULTLANG_SYNDICATE_EXPORTED void retire(void const* source);
+
+		// Retires `node` and every edge on it, whichever source added them.
+		CULTLANG_SYNDICATE_EXPORTED void retireNode(Graph::Node const* node);
+
+		inline bool isRetired(Graph::Node const* node) const
+		{
+			return (!_retired.empty() && _retired.count(node) != 0) || (_overlay != nullptr && _overlay->base().isRetired(node));
+		}
+		inline bool isRetired(Graph::Edge const* edge) const
+		{
+			return (!_retired.empty() && _retired.count(edge) != 0) || (_overlay != nullptr && _overlay->base().isRetired(edge));
+		}
+
+		// Runs `definer(context)` the first time `node` is required, rather than now.
+		CULTLANG_SYNDICATE_EXPORTED void defer(Graph::Node const* node, void (*definer)(void*), void* context);
+
+		// Runs the deferred definition of `node`, and of everything it is-a, if they have not run.
+		// Store lookups and dispatch do this for the nodes they are given.
+		inline void require(Graph::Node const* node) const
+		{
+			auto stripes = _deferredStripes.load(std::memory_order_acquire);
+			if (stripes != nullptr && stripes[_stripe(node, _nodeStripeBits)].load(std::memory_order_acquire) != 0)
+				_require(node);
+			if (_overlay != nullptr)
+				_overlay->base().require(node);
+		}
+
+		// Runs every deferred definition.
+		CULTLANG_SYNDICATE_EXPORTED void requireAll();
+		CULTLANG_SYNDICATE_EXPORTED size_t deferredCount() const;
+
+		// Adds a node and records the change, nodes should always be added here.
+		template<typename T>
+		inline Graph::Node* addNode(T const& data);
+
+		// Adds an edge between `nodes` and records the change, edges should always be added here.
+		template<typename T, typename... TNodes>
+		inline Graph::Edge* addEdge(T const& data, TNodes*... nodes);
+
+		// Adds an `EIsA` edge and keeps the subtype index in step with it.
+		CULTLANG_SYNDICATE_EXPORTED Graph::Edge* addIsA(Graph::Node* sub, Graph::Node* super);
+
+		// Connects a function to a dispatcher with an `EUsingDispatcherFunction` edge.
+		CULTLANG_SYNDICATE_EXPORTED Graph::Edge* addMethod(Graph::Node* dispatcher, Graph::Node* function);
+
+		// Restricts `function` to calls where argument `argument` is a `type` with the value `key`.
+		CULTLANG_SYNDICATE_EXPORTED Graph::Node* addValueSpecializer(Graph::Node* function, size_t argument, TypeId type, uint64_t key);
+
+		// Adds a prop to a node and indexes it, props on nodes should always be added here.
+		template<typename T>
+		inline void addProp(T const& data, Graph::Node* node);
+
+		// Adds a prop to an edge and records the change.
+		template<typename T>
+		inline void addProp(T const& data, Graph::Edge* edge);
+
+		// The prop of type `T` on `node` (as `Graph::onlyPropOfTypeOnNode`), in constant time.
+		template<typename T>
+		inline T* onlyPropOfTypeOnNode(Graph::Node const* node) const;
+
+		// Every live node of type `type` added through the store, in an overlay the base's first.
+		// Definitions deferred but not yet run have not added their edges and props, `requireAll`
+		// first to enumerate those as well. Lock free, as are the enumerations below.
+		template<typename F>
+		inline void forAllNodesOfType(void const* type, F const& f) const
+		{
+			if (_overlay != nullptr)
+				_overlay->base().forAllNodesOfType(type, f);
+			_forAllOfType(_nodesOfType, type, f);
+		}
+		template<typename T, typename F>
+		inline void forAllNodesOfType(F const& f) const { forAllNodesOfType(GraphConfig::typed_typeToValue<T>().node, f); }
+
+		// Every live edge of type `type`, as above. An overlay's edges hold shadows (see `canonical`).
+		template<typename F>
+		inline void forAllEdgesOfType(void const* type, F const& f) const
+		{
+			if (_overlay != nullptr)
+				_overlay->base().forAllEdgesOfType(type, f);
+			_forAllOfType(_edgesOfType, type, f);
+		}
+		template<typename T, typename F>
+		inline void forAllEdgesOfType(F const& f) const { forAllEdgesOfType(GraphConfig::typed_typeToValue<T>().node, f); }
+
+		// Every node with a prop of type `T`, with the prop `onlyPropOfTypeOnNode` would find.
+		template<typename T, typename F>
+		inline void forAllNodesWithProp(F const& f) const;
 
 		CULTLANG_SYNDICATE_EXPORTED std::string describeNode(Graph::Node const*);
 	};
+
+	/******************************************************************************
+	** TypeStore inline defines
+	******************************************************************************/
+
+	inline TypeStore::_Added* TypeStore::_added()
+	{
+		auto source = Source::current();
+		return source != nullptr ? &_sources[source] : nullptr;
+	}
+
+	template<typename T>
+	inline Graph::Node* TypeStore::addNode(T const& data)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_write);
+		PayloadArena::Scope scope(_payloads);
+		auto n = const_cast<Graph::Node*>(_graph.template addNode<T>(data));
+		if (_overlay != nullptr)
+			_overlay->own(n);
+		if (auto added = _added())
+			added->nodes.push_back(n);
+		auto type = GraphConfig::typed_typeToValue<T>().node;
+		_nodesOfType.require(type).push_back(n);
+		_bump(type, { n });
+		return n;
+	}
+
+	template<typename T, typename... TNodes>
+	inline Graph::Edge* TypeStore::addEdge(T const& data, TNodes*... nodes)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_write);
+		PayloadArena::Scope scope(_payloads);
+		auto e = _graph.template addEdge<T>(data, { _local(nodes)... });
+		if (_overlay != nullptr)
+			_overlay->own(e);
+		if (auto added = _added())
+			added->edges.push_back(e);
+		auto type = GraphConfig::typed_typeToValue<T>().node;
+		_edgesOfType.require(type).push_back(e);
+		_addEdgeOnNodes(e);
+		_bump(type, { nodes... });
+		return e;
+	}
+
+	template<typename T>
+	inline void TypeStore::addProp(T const& data, Graph::Node* node)
+	{
+		auto type = GraphConfig::typed_typeToValue<T>().node;
+		std::lock_guard<std::recursive_mutex> lock(_write);
+		PayloadArena::Scope scope(_payloads);
+		auto local = _local(node);
+		_graph.template addProp<T>(data, local);
+
+		// Index the newest prop of the type, so a replacement's props win over those it replaces
+		Graph::Prop const* prop = nullptr;
+		_graph.forAllPropsOnNode(local, [&](auto p)
+		{
+			if (p->type.node == type)
+				prop = p;
+		});
+		auto payload = GraphConfig::typed_load<T>(prop->data);
+		_propsOnNode.require(local).push_back(prop);
+		if (_props.require({ node, type }).exchange(payload, std::memory_order_acq_rel) == nullptr)
+			_nodesWithProp.require(type).push_back(node);
+		if (auto added = _added())
+			added->props.push_back({ node, type, payload });
+		_bump(type, { node });
+	}
+
+	template<typename T>
+	inline void TypeStore::addProp(T const& data, Graph::Edge* edge)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_write);
+		if (_overlay != nullptr && !_overlay->owns(edge))
+			throw stdext::exception("An overlay can not change the edges of it's base.");
+		PayloadArena::Scope scope(_payloads);
+		_graph.template addProp<T>(data, edge);
+		_bump(GraphConfig::typed_typeToValue<T>().node, { });
+	}
+
+	template<typename T>
+	inline T* TypeStore::onlyPropOfTypeOnNode(Graph::Node const* node) const
+	{
+		require(node);
+		{
+			Epoch::Guard guard;
+			if (auto prop = _findProp(node, GraphConfig::typed_typeToValue<T>().node))
+				return reinterpret_cast<T*>(prop);
+		}
+		return _overlay != nullptr ? _overlay->base().template onlyPropOfTypeOnNode<T>(node) : nullptr;
+	}
+
+	template<typename T, typename F>
+	inline void TypeStore::forAllNodesWithProp(F const& f) const
+	{
+		_forAllNodesWithProp(GraphConfig::typed_typeToValue<T>().node, this, [&](Graph::Node const* node, void* prop)
+		{
+			f(node, reinterpret_cast<T*>(prop));
+		});
+	}
+
+	template<typename F>
+	inline void TypeStore::_forAllNodesWithProp(void const* type, TypeStore const* top, F const& f) const
+	{
+		if (_overlay != nullptr)
+			_overlay->base()._forAllNodesWithProp(type, top, f);
+
+		Epoch::Guard guard;
+		_forAllOfType(_nodesWithProp, type, [&](Graph::Node const* node)
+		{
+			auto prop = _findProp(node, type);
+			if (prop == nullptr)
+				return;
+
+			// An overlay's own prop on a base node wins over the base's, see `onlyPropOfTypeOnNode`
+			for (auto over = top; over != this; over = over->base())
+				if (over->_findProp(node, type) != nullptr)
+					return;
+
+			f(node, prop);
+		});
+	}
 }
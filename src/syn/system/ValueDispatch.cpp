@@ -0,0 +1,158 @@
+#include "syn/syn.h"
+#include "ValueDispatch.h"
+
+using namespace syn;
+
+/******************************************************************************
+** ValueDispatch
+******************************************************************************/
+
+namespace
+{
+	template<typename T>
+	uint64_t _key_of(void const* value)
+	{
+		return value_key(*reinterpret_cast<T const*>(value));
+	}
+
+	template<typename... TTypes>
+	ValueDispatch::KeyFunction _key_function(TypeId t, std::tuple<TTypes...> const*)
+	{
+		ValueDispatch::KeyFunction res = nullptr;
+		(void)((t == type<TTypes>::id() ? (res = &_key_of<TTypes>, true) : false) || ...);
+		return res;
+	}
+}
+
+ValueDispatch::KeyFunction ValueDispatch::keyFunction(TypeId t)
+{
+	return _key_function(t, (details::value_dispatch_types const*)nullptr);
+}
+
+ValueDispatch::ValueDispatch(uint64_t revision, std::vector<Method> methods)
+	: _revision(revision)
+	, _methods(std::move(methods))
+	, _keyFunctions(_methods.size())
+	, _arguments()
+{
+	for (uint32_t m = 0; m < _methods.size(); ++m)
+	{
+		for (auto const& spec : _methods[m].values)
+		{
+			auto key_function = keyFunction(spec.type);
+			if (key_function == nullptr)
+				throw stdext::exception("Can not dispatch on values of {0}.", spec.type);
+			_keyFunctions[m].push_back(key_function);
+
+			if (_arguments.size() <= spec.argument)
+				_arguments.resize(spec.argument + 1);
+			auto& argument = _arguments[spec.argument];
+
+			auto it = std::find_if(argument.types.begin(), argument.types.end(),
+				[&](auto const& t) { return t.first == spec.type; });
+			if (it == argument.types.end())
+				argument.types.push_back({ spec.type, key_function });
+
+			argument.methods[{ spec.type, spec.key }].push_back(m);
+		}
+	}
+
+	// Most specific first: a method goes after every method more specific than it (a stable
+	// selection, the order is partial)
+	for (auto& argument : _arguments)
+	{
+		for (auto& bucket : argument.methods)
+		{
+			auto& indices = bucket.second;
+			for (size_t done = 0; done < indices.size(); ++done)
+			{
+				auto next = done;
+				for (size_t i = done; i < indices.size(); ++i)
+				{
+					bool dominated = false;
+					for (size_t j = done; j < indices.size() && !dominated; ++j)
+						dominated = j != i
+							&& more_specific(_methods[indices[j]].types, _methods[indices[i]].types)
+							&& !more_specific(_methods[indices[i]].types, _methods[indices[j]].types);
+					if (!dominated)
+					{
+						next = i;
+						break;
+					}
+				}
+				std::rotate(indices.begin() + done, indices.begin() + next, indices.begin() + next + 1);
+			}
+		}
+	}
+}
+
+bool ValueDispatch::dependsOn(TypeId const* type_args, size_t count) const
+{
+	for (size_t i = 0; i < count && i < _arguments.size(); ++i)
+		for (auto const& t : _arguments[i].types)
+			if (t.first == type_args[i])
+				return true;
+	return false;
+}
+
+bool ValueDispatch::_applies(uint32_t m, TypeId const* type_args, void const* const* value_args, size_t count) const
+{
+	auto const& method = _methods[m];
+	if (method.types.size() != count)
+		return false;
+
+	for (size_t i = 0; i < count; ++i)
+		if (method.types[i] != None && method.types[i] != type_args[i] && !is_a(type_args[i], method.types[i]))
+			return false;
+
+	for (size_t v = 0; v < method.values.size(); ++v)
+	{
+		auto const& spec = method.values[v];
+		if (spec.argument >= count || type_args[spec.argument] != spec.type || value_args[spec.argument] == nullptr)
+			return false;
+		if (_keyFunctions[m][v](value_args[spec.argument]) != spec.key)
+			return false;
+	}
+
+	return true;
+}
+
+TypeId ValueDispatch::lookup(TypeId const* type_args, void const* const* value_args, size_t count) const
+{
+	for (size_t i = 0; i < count && i < _arguments.size(); ++i)
+	{
+		auto const& argument = _arguments[i];
+		if (value_args[i] == nullptr)
+			continue;
+
+		auto type_it = std::find_if(argument.types.begin(), argument.types.end(),
+			[&](auto const& t) { return t.first == type_args[i]; });
+		if (type_it == argument.types.end())
+			continue;
+
+		auto it = argument.methods.find({ type_args[i], type_it->second(value_args[i]) });
+		if (it == argument.methods.end())
+			continue;
+
+		// Only the first applicable method can be the most specific, it is if it beats the rest
+		auto const& indices = it->second;
+		size_t first = 0;
+		while (first < indices.size() && !_applies(indices[first], type_args, value_args, count))
+			first += 1;
+		if (first == indices.size())
+			continue;
+
+		auto const& candidate = _methods[indices[first]];
+		bool best = true;
+		for (size_t o = first + 1; o < indices.size() && best; ++o)
+		{
+			auto const& other = _methods[indices[o]];
+			if (!more_specific(candidate.types, other.types) || more_specific(other.types, candidate.types))
+				best = !_applies(indices[o], type_args, value_args, count);
+		}
+		if (best)
+			return candidate.function;
+	}
+
+	return None;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "syn/syn.h"
+
+namespace syn
+{
+	/******************************************************************************
+	** value keys
+	******************************************************************************/
+
+	namespace details
+	{
+		// Every type that can be value dispatched, `ValueDispatch::keyFunction` reads the keys of
+		// exactly these.
+		using value_dispatch_types = std::tuple<Symbol, TypeId,
+			uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t, int32_t, int64_t>;
+
+		template<typename T, typename TTuple>
+		struct tuple_contains;
+
+		template<typename T, typename... TTypes>
+		struct tuple_contains<T, std::tuple<TTypes...>>
+			: std::bool_constant<(std::is_same_v<T, TTypes> || ...)>
+		{ };
+	}
+
+	// Values that can be dispatched on are hashed by a 64 bit key (together with their type).
+	template<typename T>
+	struct value_dispatchable
+	{
+		static constexpr bool value = details::tuple_contains<T, details::value_dispatch_types>::value;
+	};
+
+	template<typename T>
+	inline uint64_t value_key(T const& value)
+	{
+		static_assert(value_dispatchable<T>::value, "Only symbols, fixed width integers and type ids can be value dispatched.");
+
+		if constexpr (std::is_same_v<T, Symbol>)
+			return (uint64_t)(uintptr_t)value;
+		else if constexpr (std::is_same_v<T, TypeId>)
+			return (uint64_t)(uintptr_t)(Graph::Node const*)value;
+		else
+			return (uint64_t)(int64_t)value;
+	}
+
+	/******************************************************************************
+	** ValueDispatch
+	******************************************************************************/
+
+	/* The value specialized methods of a dispatcher, hashed per argument position.
+	 *
+	 * Each argument position with a `NValueSpecializer` gets a table from (type, key) to the methods
+	 * specialized on it, so a lookup is one hash probe per such argument before type dispatch. The
+	 * leftmost argument with an applicable method wins; within it the most specific method is
+	 * picked as usual. The methods under each (type, key) are ordered most specific first when the
+	 * table is built, so a lookup takes the first applicable one and only checks it against the
+	 * rest, without allocating. Value specialized methods never take part in type dispatch. Tables
+	 * are immutable and tagged with the dispatcher revision they were built at, `DispatchCache`
+	 * rebuilds them when it moves.
+	 */
+	class ValueDispatch final
+	{
+	public:
+		struct Specializer
+		{
+			size_t argument;
+			TypeId type;
+			uint64_t key;
+		};
+
+		struct Method
+		{
+			TypeId function;
+			std::vector<TypeId> types;
+			std::vector<Specializer> values;
+		};
+
+		typedef uint64_t (*KeyFunction)(void const*);
+
+		// Reads the key of a value of `type`, `nullptr` if `type` can not be value dispatched.
+		CULTLANG_SYNDICATE_EXPORTED static KeyFunction keyFunction(TypeId type);
+
+	private:
+		struct _Key
+		{
+			TypeId type;
+			uint64_t key;
+
+			inline bool operator==(_Key const& that) const { return type == that.type && key == that.key; }
+		};
+
+		struct _KeyHash
+		{
+			inline size_t operator()(_Key const& k) const
+			{
+				return std::hash<uintptr_t>()((uintptr_t)(Graph::Node const*)k.type) ^ std::hash<uint64_t>()(k.key) * 31;
+			}
+		};
+
+		struct _Argument
+		{
+			std::vector<std::pair<TypeId, KeyFunction>> types;
+			// Method indices, most specific first
+			std::unordered_map<_Key, std::vector<uint32_t>, _KeyHash> methods;
+		};
+
+		uint64_t _revision;
+		std::vector<Method> _methods;
+		// Parallel to each method's `values`
+		std::vector<std::vector<KeyFunction>> _keyFunctions;
+		std::vector<_Argument> _arguments;
+
+		bool _applies(uint32_t method, TypeId const* type_args, void const* const* value_args, size_t count) const;
+
+	public:
+		CULTLANG_SYNDICATE_EXPORTED ValueDispatch(uint64_t revision, std::vector<Method> methods);
+
+		inline uint64_t revision() const { return _revision; }
+		inline bool empty() const { return _methods.empty(); }
+
+		// Whether any value specializer could apply to arguments of these types.
+		CULTLANG_SYNDICATE_EXPORTED bool dependsOn(TypeId const* type_args, size_t count) const;
+
+		// The method for these argument values, `None` to fall back to type dispatch.
+		CULTLANG_SYNDICATE_EXPORTED TypeId lookup(TypeId const* type_args, void const* const* value_args, size_t count) const;
+	};
+}
@@ -7,32 +7,238 @@ bool syn::is_a(TypeId most_specific, TypeId less_specific)
 {
     if (most_specific == less_specific)
         return true;
-    if (most_specific == 0 || less_specific == 0)
+    if (most_specific == None || less_specific == None)
         return false;
 
-    // TODO sort this and save to cache
-    auto res = graph::query(&thread_store().g())
-        .v(most_specific)
-        .repeat_breadth(
-            [](auto sq) { return sq.out([](auto e) { return e->type == type<core::EIsA>::id(); }); },
-            []() { return true; },
-            [&](auto n) { return n == less_specific; }
-        )
-        .take(1)
-        .run();
+    auto& store = thread_store();
+    store.require(most_specific);
+    return store.isA(most_specific, less_specific);
+}
 
-    return res.size() == 1 && res[0] == less_specific;
+bool syn::more_specific(std::vector<TypeId> const& a, std::vector<TypeId> const& b)
+{
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (b[i] == None) continue;
+        if (a[i] == None || !is_a(a[i], b[i])) return false;
+    }
+    return true;
 }
 
-TypeId syn::basic_dispatch(TypeId dispatcher, TypeId* type_args, size_t count, void* value_args /* = nullptr */, TypeId previous_call /* = nullptr */)
+namespace
 {
-    // TODO save this to a cache
-    std::vector<std::vector<TypeId>> dispatch_table_by_arg;
-    for (int i = 0; i < count; ++i)
+    // Runs any deferred definitions a dispatch depends on, before it reads the dispatcher's revision.
+    inline void _require(TypeStore const& store, TypeId dispatcher, TypeId const* type_args, size_t count)
+    {
+        store.require(dispatcher);
+        for (size_t i = 0; i < count; ++i)
+            if (type_args[i] != None)
+                store.require(type_args[i]);
+    }
+
+    // Every function on `dispatcher` with the types it is dispatched on, and any value specializers.
+    template<typename TFunc>
+    void _forAllMethods(TypeStore& store, TypeId dispatcher, TFunc const& f)
+    {
+        static QueryPlan const functions_plan = QueryPlan().out(type<core::EUsingDispatcherFunction>::id());
+        static QueryPlan const specializers_plan = QueryPlan().out(type<core::ESpecializesArgument>::id());
+
+        // Not thread local, `f` may dispatch (e.g. by requiring a deferred definition)
+        QueryPlan::Scratch functions, specializers;
+        functions_plan.run(store, (Graph::Node const*)dispatcher, functions);
+
+        std::vector<ValueDispatch::Specializer> values;
+        for (auto function : functions.results())
+        {
+            auto args = store.template onlyPropOfTypeOnNode<core::PDispatchArguments>(function);
+            if (args == nullptr)
+                continue;
+
+            values.clear();
+            specializers_plan.run(store, function, specializers);
+            for (auto specializer : specializers.results())
+            {
+                auto spec = GraphConfig::typed_load<core::NValueSpecializer>(specializer->data);
+                values.push_back({ spec->argument, spec->type, spec->key });
+            }
+
+            f(function, args->types, values);
+        }
+    }
+
+    // The value tables of `dispatcher` at `revision`, built on demand. Must be called under a guard.
+    ValueDispatch const* _values(TypeStore& store, DispatchCache& cache, TypeId dispatcher, uint64_t revision)
     {
+        auto values = cache.values();
+        if (values != nullptr && values->revision() == revision)
+            return values;
 
+        std::vector<ValueDispatch::Method> methods;
+        _forAllMethods(store, dispatcher, [&](Graph::Node const* function, std::vector<TypeId> const& types, std::vector<ValueDispatch::Specializer> const& specs)
+        {
+            if (!specs.empty())
+                methods.push_back({ function, types, specs });
+        });
+
+        auto built = new ValueDispatch(revision, std::move(methods));
+        cache.setValues(built);
+        return built;
     }
 
-    // no dispatch
-    return None;
+    TypeId _resolve(TypeStore& store, TypeId dispatcher, TypeId const* type_args, size_t count)
+    {
+        std::vector<std::pair<Graph::Node const*, std::vector<TypeId> const*>> applicable;
+        _forAllMethods(store, dispatcher, [&](Graph::Node const* function, std::vector<TypeId> const& types, std::vector<ValueDispatch::Specializer> const& values)
+        {
+            if (types.size() != count || !values.empty())
+                return;
+
+            for (size_t i = 0; i < count; ++i)
+                if (types[i] != None && !is_a(type_args[i], types[i]))
+                    return;
+
+            applicable.push_back({ function, &types });
+        });
+
+        // The most specific method must be at least as specific as every other candidate
+        for (auto const& candidate : applicable)
+        {
+            bool best = true;
+            for (auto const& other : applicable)
+            {
+                if (other.first == candidate.first) continue;
+                if (!more_specific(*candidate.second, *other.second)
+                    || more_specific(*other.second, *candidate.second))
+                {
+                    best = false;
+                    break;
+                }
+            }
+
+            if (best)
+                return candidate.first;
+        }
+
+        // no dispatch (or ambiguous)
+        return None;
+    }
+}
+
+namespace
+{
+    DispatchCache& _dispatchCache(TypeStore& store, TypeId dispatcher)
+    {
+        // Overlays may add methods to the base's dispatchers, so they keep their own caches
+        if (auto overlay = store.overlay())
+            return overlay->dispatchCache((Graph::Node const*)dispatcher);
+
+        auto state = &DispatchCache::on((Graph::Node const*)dispatcher);
+
+        auto cache = state->load(std::memory_order_acquire);
+        if (cache != nullptr)
+            return *cache;
+
+        // Racing threads may both build one, only the first to publish is kept.
+        auto fresh = new DispatchCache();
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+        fresh->statsIndex = details::dispatch_stats_register(dispatcher);
+#endif
+        if (state->compare_exchange_strong(cache, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+            return *fresh;
+
+        delete fresh;
+        return *cache;
+    }
+}
+
+DispatchCache& syn::dispatch_cache(TypeId dispatcher)
+{
+    return _dispatchCache(thread_store(), dispatcher);
+}
+
+CompiledDispatch const& syn::compile_dispatcher(TypeId dispatcher)
+{
+    auto& store = thread_store();
+    if (store.base() != nullptr)
+        throw stdext::exception("Dispatcher {0} can not be compiled in an overlay store.", dispatcher);
+    store.require(dispatcher);
+    auto revision = store.dispatchRevision((Graph::Node const*)dispatcher);
+
+    std::vector<CompiledDispatch::Method> methods;
+    _forAllMethods(store, dispatcher, [&](Graph::Node const* function, std::vector<TypeId> const& types, std::vector<ValueDispatch::Specializer> const& values)
+    {
+        if (values.empty())
+            methods.push_back({ function, types });
+    });
+
+    CompiledDispatch* compiled;
+    {
+        // Initers or deferred definitions may be adding `EIsA` edges on other threads
+        auto lock = store.lockWrites();
+        compiled = new CompiledDispatch(revision, methods, store.subtypes());
+    }
+    _dispatchCache(store, dispatcher).setCompiled(compiled);
+    return *compiled;
+}
+
+bool syn::value_dispatched(TypeId dispatcher, TypeId const* type_args, size_t count)
+{
+    auto& store = thread_store();
+    _require(store, dispatcher, type_args, count);
+
+    Epoch::Guard guard;
+    return _values(store, _dispatchCache(store, dispatcher), dispatcher, store.dispatchRevision((Graph::Node const*)dispatcher))->dependsOn(type_args, count);
+}
+
+namespace
+{
+    inline TypeId _dispatch(TypeStore& store, DispatchCache& cache, TypeId dispatcher, TypeId* type_args, size_t count, void const* const* value_args, bool& missed)
+    {
+        _require(store, dispatcher, type_args, count);
+        auto revision = store.dispatchRevision((Graph::Node const*)dispatcher);
+
+        TypeId result;
+        if (value_args != nullptr)
+        {
+            Epoch::Guard guard;
+            auto values = _values(store, cache, dispatcher, revision);
+            if (!values->empty() && (result = values->lookup(type_args, value_args, count)) != None)
+                return result;
+        }
+
+        if (cache.findCompiled(revision, type_args, count, result))
+            return result;
+        if (cache.find(revision, type_args, count, result))
+            return result;
+
+        missed = true;
+        result = _resolve(store, dispatcher, type_args, count);
+        cache.insert(revision, type_args, count, result);
+        return result;
+    }
+}
+
+TypeId syn::basic_dispatch(TypeId dispatcher, TypeId* type_args, size_t count, void const* const* value_args /* = nullptr */, TypeId previous_call /* = nullptr */)
+{
+    auto& store = thread_store();
+    auto& cache = _dispatchCache(store, dispatcher);
+    bool missed = false;
+
+#ifdef CULTLANG_SYNDICATE_DISPATCH_STATS
+    using details::DispatchCounter;
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = _dispatch(store, cache, dispatcher, type_args, count, value_args, missed);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    details::dispatch_stats_count(cache.statsIndex, DispatchCounter::Dispatches);
+    details::dispatch_stats_count(cache.statsIndex, missed ? DispatchCounter::CacheMisses : DispatchCounter::CacheHits);
+    if (missed)
+        details::dispatch_stats_tuple(cache.statsIndex, type_args, count);
+    details::dispatch_stats_latency(cache.statsIndex, (uint64_t)elapsed);
+
+    return result;
+#else
+    return _dispatch(store, cache, dispatcher, type_args, count, value_args, missed);
+#endif
 }
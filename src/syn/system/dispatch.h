@@ -6,5 +6,23 @@ namespace syn
 {
 	CULTLANG_SYNDICATE_EXPORTED bool is_a(TypeId most_specific, TypeId less_specific);
 
-	CULTLANG_SYNDICATE_EXPORTED TypeId basic_dispatch(TypeId dispatcher, TypeId* type_args, size_t count, void* value_args = nullptr, TypeId previous_call = nullptr);
+	// `a` is at least as specific as `b` in every argument (`None` is the least specific).
+	CULTLANG_SYNDICATE_EXPORTED bool more_specific(std::vector<TypeId> const& a, std::vector<TypeId> const& b);
+
+	// The cache stored in the `NDispatcher::dispatcher_state` of `dispatcher`, created on demand.
+	CULTLANG_SYNDICATE_EXPORTED DispatchCache& dispatch_cache(TypeId dispatcher);
+
+	// Precomputes a `CompiledDispatch` table for `dispatcher` at the dispatcher's current revision, which
+	// `basic_dispatch` prefers over it's cache until the revision changes.
+	CULTLANG_SYNDICATE_EXPORTED CompiledDispatch const& compile_dispatcher(TypeId dispatcher);
+
+	// Whether a value specialized method of `dispatcher` could apply to arguments of these types, in
+	// which case a dispatch result for them depends on the values and must not be cached by type.
+	CULTLANG_SYNDICATE_EXPORTED bool value_dispatched(TypeId dispatcher, TypeId const* type_args, size_t count);
+
+	// Resolves the most specific `NFunction` on `dispatcher` for the given argument types, `None` if
+	// there is no unique one. Results are memoized per dispatcher by argument types. If `value_args`
+	// (a pointer to each argument's value, or null) is given value specialized methods are tried
+	// first, see `ValueDispatch`.
+	CULTLANG_SYNDICATE_EXPORTED TypeId basic_dispatch(TypeId dispatcher, TypeId* type_args, size_t count, void const* const* value_args = nullptr, TypeId previous_call = nullptr);
 }
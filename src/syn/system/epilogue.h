@@ -3,5 +3,19 @@
 
 namespace syn
 {
-    
+	/******************************************************************************
+	** DispatchCache inline defines
+	******************************************************************************/
+
+	inline std::atomic<DispatchCache*>& DispatchCache::on(Graph::Node const* dispatcher)
+	{
+		static_assert(sizeof(core::NDispatcher) <= sizeof(void*), "NDispatcher must be packed into the node.");
+		static_assert(sizeof(std::atomic<DispatchCache*>) == sizeof(void*) && std::atomic<DispatchCache*>::is_always_lock_free,
+			"dispatcher_state must be usable as an atomic pointer.");
+
+		// `typed_load` returns null for an all zero packed value, so address the packed storage directly.
+		auto node = const_cast<Graph::Node*>(dispatcher);
+		auto data = reinterpret_cast<core::NDispatcher*>(&node->data);
+		return *reinterpret_cast<std::atomic<DispatchCache*>*>(&data->dispatcher_state);
+	}
 }
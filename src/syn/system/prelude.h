@@ -24,8 +24,10 @@ namespace syn
 		inline void _finish(char const* save, char const* name = nullptr);
 
 		inline void boot();
+		inline void boot(std::string const& snapshot);
 		inline void update();
 		inline void reset();
 		inline void load(std::string const& path);
+		inline void reload(std::string const& path);
 	}
 }
@@ -19,3 +19,128 @@ TEST_CASE( "type nodes inited", "[syn::CppSystem]" )
         CHECK(syn::type<std::string>::graphNode() != nullptr);
     }
 }
+
+namespace
+{
+    // The graph the boot built, as lines independent of scheduling and addresses: defines are
+    // named by their rank in memory (they are static, laid out alike in every run), other nodes
+    // by their type, each with the types of it's props and edges and the nodes on those. Sorted.
+    std::vector<std::string> boot_digest()
+    {
+        auto& store = syn::global_store();
+
+        std::vector<std::pair<syn::CppDefine const*, Graph::Node const*>> defines;
+        store.forAllNodesWithProp<syn::core::PCppDefine>([&](Graph::Node const* node, syn::core::PCppDefine* prop)
+        {
+            defines.push_back({ prop->define, node });
+        });
+        std::sort(defines.begin(), defines.end());
+
+        std::map<Graph::Node const*, std::string> names;
+        for (size_t i = 0; i < defines.size(); ++i)
+            names[defines[i].second] = "define" + std::to_string(i);
+
+        auto name = [&](void const* node) -> std::string
+        {
+            auto it = names.find((Graph::Node const*)node);
+            return it != names.end() ? it->second : "?";
+        };
+        auto label = [&](Graph::Node const* node) -> std::string
+        {
+            auto it = names.find(node);
+            return it != names.end() ? it->second : "<" + name(node->type.node) + ">";
+        };
+
+        std::vector<std::string> lines;
+        store.g().forAllNodes([&](Graph::Node const* node)
+        {
+            std::vector<std::string> parts;
+            store.forAllPropsOnNode(node, [&](auto p) { parts.push_back("prop " + name(p->type.node)); });
+            store.forAllEdgesOnNode(node, [&](auto e)
+            {
+                auto edge = "edge " + name(e->type.node);
+                for (auto n : e->nodes)
+                    edge += " " + ((Graph::Node const*)n == node ? std::string("*") : label((Graph::Node const*)n));
+                parts.push_back(edge);
+            });
+            std::sort(parts.begin(), parts.end());
+
+            auto line = label(node);
+            for (auto const& part : parts)
+                line += " | " + part;
+            lines.push_back(line);
+        });
+        std::sort(lines.begin(), lines.end());
+        return lines;
+    }
+
+    // Runs "boot digest" alone in a process of it's own, booting on `threads` threads.
+    std::vector<std::string> boot_digest_of(size_t threads, int& status)
+    {
+        auto command = "SYN_TEST_INIT_THREADS=" + std::to_string(threads) + " /proc/self/exe \"boot digest\"";
+
+        std::vector<std::string> lines;
+        auto pipe = popen(command.c_str(), "r");
+        REQUIRE(pipe != nullptr);
+
+        std::string line;
+        char buffer[4096];
+        while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+        {
+            line += buffer;
+            if (line.back() != '\n')
+                continue;
+
+            line.pop_back();
+            if (line.compare(0, 7, "digest ") == 0)
+                lines.push_back(line.substr(7));
+            line.clear();
+        }
+        status = pclose(pipe);
+        return lines;
+    }
+}
+
+// Only run by "parallel boot", the store must not have been booted (or changed) before
+TEST_CASE( "boot digest", "[.][syn::CppSystem]" )
+{
+    auto threads = std::getenv("SYN_TEST_INIT_THREADS");
+    if (threads != nullptr)
+        syn::system().setInitThreads(std::stoul(threads));
+    test_require_syn_boot();
+
+    // What boot did through the store is usable, whichever thread did it
+    size_t missing = 0;
+    syn::global_store().forAllNodesWithProp<syn::core::PCppDefine>([&](Graph::Node const* node, syn::core::PCppDefine* prop)
+    {
+        if (prop->define->node != node)
+            missing += 1;
+    });
+    CHECK(missing == 0);
+    CHECK(syn::is_a(syn::type<syn::core::Vector>::id(), syn::core::AbstractContainer));
+    for (auto container : { syn::type<syn::core::Vector>::id(), syn::type<syn::core::Set>::id(), syn::type<syn::core::Dictionary>::id() })
+        CHECK(syn::basic_dispatch(syn::core::count, &container, 1) != None);
+
+    for (auto const& line : boot_digest())
+        std::cout << "digest " << line << std::endl;
+}
+
+#ifdef __linux__
+TEST_CASE( "parallel boot", "[syn::CppSystem]" )
+{
+    // Each boot in a process of it's own, this one's store was booted (and changed) by other tests
+    int single_status, parallel_status;
+    auto single = boot_digest_of(1, single_status);
+    auto parallel = boot_digest_of(4, parallel_status);
+
+    CHECK(single_status == 0);
+    CHECK(parallel_status == 0);
+    CHECK(single.size() > 0);
+
+    // The same nodes, edges and props, only made in another order, the first difference shown
+    auto mismatch = std::mismatch(single.begin(), single.end(), parallel.begin(), parallel.end());
+    if (mismatch.first != single.end() && mismatch.second != parallel.end())
+        CHECK(*mismatch.first == *mismatch.second);
+    CHECK((single == parallel));
+}
+#endif
@@ -0,0 +1,62 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/cpp/dispatch/GenericInvoke.hpp"
+
+using namespace syn;
+
+TEST_CASE( "syn::GenericInvoke", "[syn::GenericInvoke]" )
+{
+    test_require_syn_boot();
+
+    auto vector = instance<core::Vector>::make();
+    instance<> arg = vector;
+
+    SECTION( "stores small arities inline" )
+    {
+        GenericInvoke invoke { arg, arg };
+
+        CHECK(invoke.size() == 2);
+        CHECK(invoke.isInline());
+        CHECK(invoke.isBorrowed() == false);
+        CHECK(invoke[0].get() == vector.get());
+        CHECK(vector.refCount() == 4);
+    }
+
+    SECTION( "spills large arities to the heap" )
+    {
+        GenericInvoke invoke;
+        for (size_t i = 0; i < GenericInvoke::InlineCount + 2; ++i)
+            invoke.push_back(arg);
+
+        CHECK(invoke.size() == GenericInvoke::InlineCount + 2);
+        CHECK(invoke.isInline() == false);
+        CHECK(invoke[GenericInvoke::InlineCount + 1].get() == vector.get());
+    }
+
+    SECTION( "takes ownership in place" )
+    {
+        GenericInvoke invoke(std::in_place, instance<>(vector));
+
+        CHECK(invoke.size() == 1);
+        CHECK(vector.refCount() == 3);
+    }
+
+    SECTION( "borrows without incref" )
+    {
+        instance<> argv[] = { arg, arg, arg };
+        REQUIRE(vector.refCount() == 5);
+
+        GenericInvoke invoke(GenericInvoke::Borrow, argv, 3);
+
+        CHECK(invoke.size() == 3);
+        CHECK(invoke.isBorrowed());
+        CHECK(invoke.data() == argv);
+        CHECK(vector.refCount() == 5);
+        CHECK_THROWS(invoke.push_back(arg));
+    }
+
+    CHECK(vector.refCount() == 2);
+}
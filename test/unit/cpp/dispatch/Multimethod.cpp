@@ -0,0 +1,308 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/cpp/dispatch/Multimethod.hpp"
+
+using namespace syn;
+
+TEST_CASE( "syn::Multimethod::invoke", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    auto vector = instance<core::Vector>::make();
+    vector->push_back(instance<>());
+    vector->push_back(instance<>());
+
+    SECTION( "calls the method for the argument types" )
+    {
+        CHECK(core::count.invoke<uint64_t>(vector) == 2);
+        CHECK(core::count.invoke<uint64_t>(instance<core::Set>::make()) == 0);
+    }
+
+    SECTION( "returns instances" )
+    {
+        auto res = core::count.invoke<instance<>>(vector);
+
+        REQUIRE(res.isNull() == false);
+        CHECK(res.typeId() == syn::type<uint64_t>::id());
+    }
+
+    SECTION( "throws when no method applies" )
+    {
+        CHECK_THROWS(core::count.invoke<uint64_t>(instance<std::string>::make("hello")));
+    }
+}
+
+TEST_CASE( "syn::Multimethod::invoke (values)", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    auto text = instance<std::string>::make("42");
+
+    SECTION( "dispatches on the value" )
+    {
+        CHECK(*test_parse.invoke<instance<uint64_t>>(type<uint64_t>::id(), text) == 42);
+        CHECK(*test_parse.invoke<instance<int64_t>>(type<int64_t>::id(), text) == 42);
+        CHECK(*test_parse.invoke<instance<std::string>>(type<std::string>::id(), text) == "42");
+    }
+
+    SECTION( "falls back to the type" )
+    {
+        CHECK(test_parse.invoke<instance<>>(type<double>::id(), text).isNull());
+    }
+}
+
+TEST_CASE( "syn::Multimethod::invoke (static types)", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    core::Vector vector;
+    vector.push_back(instance<>());
+
+    SECTION( "static arguments are detected" )
+    {
+        CHECK(details::cpp_static_dispatch<core::Vector&>::value);
+        CHECK(details::cpp_static_dispatch<core::Vector const&, uint64_t>::value);
+        CHECK(!details::cpp_static_dispatch<core::Vector*>::value);
+        CHECK(!details::cpp_static_dispatch<instance<core::Vector>>::value);
+    }
+
+    SECTION( "calls directly" )
+    {
+        CHECK(core::count.invoke<uint64_t>(vector) == 1);
+        CHECK(core::count.invoke<uint64_t>(vector) == 1);
+    }
+
+    SECTION( "falls back to generic calls for instance results" )
+    {
+        auto res = core::count.invoke<instance<uint64_t>>(vector);
+
+        REQUIRE(res.isNull() == false);
+        CHECK(*res == 1);
+    }
+
+    SECTION( "throws when no method applies" )
+    {
+        CHECK_THROWS(core::count.invoke<uint64_t>(std::string("hello")));
+    }
+}
+
+namespace
+{
+    // Neither has a type define, so the results can't be checked against each other
+    struct UnregisteredSmall
+    {
+        uint8_t value;
+    };
+    struct UnregisteredLarge
+    {
+        uint64_t values[16];
+    };
+
+    syn::Multimethod<> unregistered_result(
+        [](auto _) {
+            _.name("test_unregistered_result");
+
+            _.method([](core::Vector& vector) { return UnregisteredSmall { 7 }; });
+        });
+}
+
+TEST_CASE( "syn::Multimethod::invoke (unregistered results)", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    core::Vector vector;
+
+    SECTION( "ignored results are still called directly" )
+    {
+        unregistered_result.invoke(vector);
+    }
+
+    SECTION( "are never written directly into the caller's result" )
+    {
+        CHECK_THROWS(unregistered_result.invoke<UnregisteredLarge>(vector));
+        CHECK_THROWS(unregistered_result.invoke<UnregisteredSmall>(vector));
+    }
+}
+
+namespace
+{
+    syn::Multimethod<> append_nothing(
+        [](auto _) {
+            _.name("test_append_nothing");
+
+            _.method([](core::Vector& vector) { vector.push_back(instance<>()); return (uint64_t)vector.size(); });
+        });
+
+    syn::Multimethod<> append_nothing_at(
+        [](auto _) {
+            _.name("test_append_nothing_at");
+
+            _.method([](core::Vector* vector) { vector->push_back(instance<>()); return (uint64_t)vector->size(); });
+        });
+}
+
+TEST_CASE( "syn::Multimethod::invoke (by reference)", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    core::Vector vector;
+
+    SECTION( "changes the caller's argument through a direct call" )
+    {
+        CHECK(append_nothing.invoke<uint64_t>(vector) == 1);
+        CHECK(vector.size() == 1);
+    }
+
+    SECTION( "changes the caller's argument through a generic call" )
+    {
+        auto res = append_nothing.invoke<instance<uint64_t>>(vector);
+        REQUIRE(res.isNull() == false);
+        CHECK(*res == 1);
+        CHECK(vector.size() == 1);
+    }
+
+    SECTION( "changes the caller's argument through a call site" )
+    {
+        CallSiteCache<1> site;
+        CHECK(append_nothing.invokeAt<uint64_t>(site, vector) == 1);
+        CHECK(vector.size() == 1);
+    }
+
+    SECTION( "passes pointers as their pointee" )
+    {
+        CHECK(append_nothing.invoke<uint64_t>(&vector) == 1);
+        CHECK(append_nothing_at.invoke<uint64_t>(&vector) == 2);
+        CHECK(vector.size() == 2);
+
+        auto set = instance<core::Set>::make();
+        CHECK_THROWS(append_nothing_at.invoke<uint64_t>(set.get()));
+    }
+
+    SECTION( "packs pointers to defined types only" )
+    {
+        CHECK(details::cpp_packable<core::Vector*>::value);
+        CHECK(details::cpp_packable<core::Vector const*>::value);
+        CHECK(!details::cpp_packable<void*>::value);
+        CHECK(!details::cpp_packable<core::Vector**>::value);
+        CHECK(!details::cpp_packable<UnregisteredSmall>::value);
+    }
+}
+
+TEST_CASE( "syn::CallSiteCache", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    auto vector = instance<core::Vector>::make();
+    auto set = instance<core::Set>::make();
+    auto dictionary = instance<core::Dictionary>::make();
+
+    SECTION( "monomorphic" )
+    {
+        CallSiteCache<1> site;
+        core::count.invokeAt<uint64_t>(site, vector);
+        core::count.invokeAt<uint64_t>(site, vector);
+
+        CHECK(site.count() == 1);
+        CHECK(!site.isMegamorphic());
+    }
+
+    SECTION( "polymorphic" )
+    {
+        CallSiteCache<1> site;
+        core::count.invokeAt<uint64_t>(site, vector);
+        core::count.invokeAt<uint64_t>(site, set);
+
+        CHECK(site.count() == 2);
+        CHECK(!site.isMegamorphic());
+    }
+
+    SECTION( "megamorphic" )
+    {
+        CallSiteCache<1, 2> site;
+        CHECK(core::count.invokeAt<uint64_t>(site, vector) == 0);
+        CHECK(core::count.invokeAt<uint64_t>(site, set) == 0);
+        CHECK(core::count.invokeAt<uint64_t>(site, dictionary) == 0);
+
+        CHECK(site.count() == 2);
+        CHECK(site.isMegamorphic());
+    }
+
+    SECTION( "invalidated by the dispatcher's revision" )
+    {
+        CallSiteCache<1> site;
+        core::count.invokeAt<uint64_t>(site, vector);
+
+        std::array<TypeId, 1> args = { vector.typeId() };
+        auto revision = global_store().dispatchRevision(core::count.node);
+        CHECK(site.find(core::count, args, revision) != nullptr);
+        CHECK(site.find(core::count, args, revision + 1) == nullptr);
+
+        // Resolving again replaces the stale entry
+        auto target = *site.find(core::count, args, revision);
+        site.insert(core::count, args, revision + 1, target);
+        CHECK(site.count() == 1);
+        CHECK(site.find(core::count, args, revision + 1) != nullptr);
+    }
+}
+
+TEST_CASE( "syn::CallSiteCaches", "[syn::Multimethod]" )
+{
+    test_require_syn_boot();
+
+    TypeStore store;
+    std::vector<Graph::Node const*> dispatchers;
+    for (size_t i = 0; i < 6; ++i)
+        dispatchers.push_back(store.addNode<core::NDispatcher>({ }));
+
+    TypeId types[] = { type<core::Vector>::id(), type<core::Set>::id(), type<core::Dictionary>::id(), type<std::string>::id(), type<uint64_t>::id() };
+    auto target = CallTarget { None, nullptr, nullptr, nullptr };
+
+    SECTION( "keeps a cache per dispatcher" )
+    {
+        CallSiteCaches<1> caches;
+        auto first = dispatchers[0];
+        for (auto t : types)
+            caches.of(first).insert(first, { t }, 0, target);
+        CHECK(caches.of(first).isMegamorphic());
+
+        // The first being megamorphic doesn't stop any other dispatcher of the signature caching
+        for (size_t i = 1; i < dispatchers.size(); ++i)
+        {
+            auto d = dispatchers[i];
+            auto& site = caches.of(d);
+            CHECK(!site.isMegamorphic());
+            site.insert(d, { types[0] }, 0, target);
+            CHECK(site.find(d, { types[0] }, 0) != nullptr);
+        }
+    }
+
+    SECTION( "starts empty for a dispatcher taking a cache over" )
+    {
+        CallSiteCaches<1, 1> caches;
+        for (auto t : types)
+            caches.of(dispatchers[0]).insert(dispatchers[0], { t }, 0, target);
+        CHECK(caches.of(dispatchers[0]).isMegamorphic());
+
+        auto& site = caches.of(dispatchers[1]);
+        CHECK(site.count() == 0);
+        CHECK(!site.isMegamorphic());
+        site.insert(dispatchers[1], { types[0] }, 0, target);
+        CHECK(site.find(dispatchers[1], { types[0] }, 0) != nullptr);
+    }
+
+    SECTION( "invoke keeps resolving many multimethods of one arity" )
+    {
+        core::Vector vector;
+        for (size_t round = 0; round < 3; ++round)
+        {
+            CHECK(core::count.invoke<uint64_t>(instance<core::Set>::make()) == 0);
+            CHECK(append_nothing.invoke<uint64_t>(&vector) == 1 + 2 * round);
+            CHECK(append_nothing_at.invoke<uint64_t>(&vector) == 2 + 2 * round);
+            CHECK_THROWS(unregistered_result.invoke<UnregisteredSmall>(&vector));
+            CHECK(core::count.invoke<uint64_t>(instance<core::Dictionary>::make()) == 0);
+        }
+    }
+}
@@ -16,3 +16,23 @@ void test_require_syn_boot()
         syn::dll::boot();
     });
 }
+
+syn::Multimethod<> test_parse(
+    [](auto _) {
+        _.name("test_parse");
+
+        _.method([](syn::TypeId type, syn::instance<std::string> str){
+            return syn::instance<>();
+        });
+
+        // Dispatched on the value of the requested type
+        _.template methodForValue<0>(syn::type<std::string>::id(), [](syn::TypeId type, syn::instance<std::string> str){
+            return syn::instance<std::string>::make(*str);
+        });
+        _.template methodForValue<0>(syn::type<uint64_t>::id(), [](syn::TypeId type, syn::instance<std::string> str){
+            return syn::instance<uint64_t>::make(std::stoull(*str));
+        });
+        _.template methodForValue<0>(syn::type<int64_t>::id(), [](syn::TypeId type, syn::instance<std::string> str){
+            return syn::instance<int64_t>::make(std::stoll(*str));
+        });
+    });
@@ -1,3 +1,9 @@
 #pragma once
 
-void test_require_syn_boot();
\ No newline at end of file
+#include "syn/syn.h"
+
+void test_require_syn_boot();
+
+// Parses a string (argument 1) as the type given by argument 0, with value methods for
+// `std::string`, `uint64_t` and `int64_t` and a type method returning nothing for the rest.
+extern syn::Multimethod<> test_parse;
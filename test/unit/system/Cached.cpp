@@ -0,0 +1,47 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/Cached.h"
+
+using namespace syn;
+
+TEST_CASE( "syn::Cached", "[syn::Cached]" )
+{
+    test_require_syn_boot();
+
+    TypeStore store;
+    auto a = store.addNode<core::NAbstract>({ });
+    auto b = store.addNode<core::NAbstract>({ });
+
+    size_t computed = 0;
+    Cached<size_t> supers({ store.typeRevision<core::EIsA>(), store.nodeRevision(a) });
+    auto count_supers = [&]()
+    {
+        computed += 1;
+        size_t res = 0;
+        store.g().forAllEdgesOnNode(a, [&](auto e)
+        {
+            if (TypeId(e->type) == type<core::EIsA>::id() && e->nodes[0] == a)
+                res += 1;
+        });
+        return res;
+    };
+
+    CHECK(supers.valid() == false);
+    CHECK(supers.get(count_supers) == 0);
+    CHECK(supers.get(count_supers) == 0);
+    CHECK(computed == 1);
+    CHECK(supers.valid());
+
+    store.addIsA(a, b);
+
+    CHECK(supers.valid() == false);
+    CHECK(supers.get(count_supers) == 1);
+    CHECK(computed == 2);
+
+    supers.invalidate();
+    supers.get(count_supers);
+    CHECK(computed == 3);
+}
@@ -0,0 +1,78 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/CompiledDispatch.h"
+
+using namespace syn;
+
+TEST_CASE( "syn::CompiledDispatch", "[syn::CompiledDispatch]" )
+{
+    test_require_syn_boot();
+
+    // Functions are only returned, never called, so any distinct ids will do
+    TypeId numeric_numeric = TypeId(uintptr_t(0x10)), integral_integral = TypeId(uintptr_t(0x20)),
+        u64_any = TypeId(uintptr_t(0x30)), floating_signed = TypeId(uintptr_t(0x40)), unary = TypeId(uintptr_t(0x50));
+
+    std::vector<CompiledDispatch::Method> methods = {
+        { numeric_numeric, { core::Numeric, core::Numeric } },
+        { integral_integral, { core::Integral, core::Integral } },
+        { u64_any, { type<uint64_t>::id(), None } },
+        { floating_signed, { core::Floating, core::Signed } },
+        { unary, { core::Numeric } },
+    };
+
+    CompiledDispatch compiled(thread_store().revision(), methods, thread_store().subtypes());
+
+    auto lookup = [&](std::vector<TypeId> args) { return compiled.lookup(args.data(), args.size()); };
+
+    SECTION( "picks the most specific method" )
+    {
+        CHECK(lookup({ type<double>::id(), type<float>::id() }) == numeric_numeric);
+        CHECK(lookup({ type<int8_t>::id(), type<uint16_t>::id() }) == integral_integral);
+        CHECK(lookup({ type<double>::id(), type<int32_t>::id() }) == floating_signed);
+        CHECK(lookup({ type<float>::id(), type<uint32_t>::id() }) == numeric_numeric);
+    }
+
+    SECTION( "wildcards" )
+    {
+        CHECK(lookup({ type<uint64_t>::id(), type<std::string>::id() }) == u64_any);
+        CHECK(lookup({ type<uint64_t>::id(), None }) == u64_any);
+    }
+
+    SECTION( "ambiguous" )
+    {
+        // Both `(uint64_t, *)` and `(Integral, Integral)` apply, neither is more specific
+        CHECK(lookup({ type<uint64_t>::id(), type<uint8_t>::id() }) == None);
+    }
+
+    SECTION( "no method" )
+    {
+        CHECK(lookup({ type<std::string>::id(), type<double>::id() }) == None);
+        CHECK(lookup({ type<double>::id(), type<double>::id(), type<double>::id() }) == None);
+        CHECK(lookup({ }) == None);
+    }
+
+    SECTION( "arities" )
+    {
+        CHECK(lookup({ type<int16_t>::id() }) == unary);
+        CHECK(lookup({ type<std::string>::id() }) == None);
+    }
+
+    SECTION( "agrees with basic dispatch" )
+    {
+        TypeId types[] = {
+            type<core::Vector>::id(), type<core::Set>::id(), type<core::ByteVector>::id(),
+            type<core::Dictionary>::id(), type<std::string>::id(), None,
+        };
+
+        std::vector<TypeId> expected;
+        for (auto& t : types)
+            expected.push_back(basic_dispatch(core::count, &t, 1));
+
+        compile_dispatcher(core::count);
+        for (size_t i = 0; i < expected.size(); ++i)
+            CHECK(basic_dispatch(core::count, &types[i], 1) == expected[i]);
+    }
+}
@@ -0,0 +1,47 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/DispatchStats.h"
+
+using namespace syn;
+
+TEST_CASE( "syn::DispatchStats", "[syn::DispatchStats]" )
+{
+    test_require_syn_boot();
+
+    SECTION( "latency percentiles" )
+    {
+        DispatchStats stats;
+        CHECK(stats.latencyPercentile(0.5) == 0);
+
+        stats.latency[3] = 90;
+        stats.latency[10] = 10;
+        CHECK(stats.latencyPercentile(0.5) == 16);
+        CHECK(stats.latencyPercentile(0.99) == 2048);
+    }
+
+    SECTION( "counts dispatches when enabled" )
+    {
+        reset_dispatch_stats();
+
+        auto vector = instance<core::Vector>::make();
+        for (size_t i = 0; i < 10; ++i)
+            core::count.invoke<uint64_t>(vector);
+
+        auto stats = dispatch_stats(core::count);
+        if (dispatch_stats_enabled())
+        {
+            CHECK(stats.calls == 10);
+            CHECK(stats.site_hits >= 9);
+            CHECK(stats.dispatches == stats.cache_hits + stats.cache_misses);
+            CHECK(stats.distinct_tuples >= 1);
+        }
+        else
+        {
+            CHECK(stats.calls == 0);
+            CHECK(stats.dispatches == 0);
+        }
+    }
+}
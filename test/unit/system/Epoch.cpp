@@ -0,0 +1,76 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/Epoch.h"
+
+using namespace syn;
+
+namespace
+{
+    struct Counted
+    {
+        std::atomic<size_t>& deleted;
+        ~Counted() { deleted += 1; }
+    };
+}
+
+TEST_CASE( "syn::Epoch", "[syn::Epoch]" )
+{
+    std::atomic<size_t> deleted { 0 };
+
+    SECTION( "retired values are deleted when no guard is held" )
+    {
+        Epoch::retire(new Counted { deleted });
+        Epoch::collect();
+
+        CHECK(deleted == 1);
+    }
+
+    SECTION( "guards delay deletion" )
+    {
+        {
+            Epoch::Guard guard;
+            Epoch::retire(new Counted { deleted });
+            Epoch::collect();
+
+            CHECK(deleted == 0);
+        }
+
+        Epoch::collect();
+        CHECK(deleted == 1);
+    }
+
+    SECTION( "guards entered after retiring do not delay deletion" )
+    {
+        Epoch::retire(new Counted { deleted });
+
+        Epoch::Guard guard;
+        Epoch::collect();
+
+        CHECK(deleted == 1);
+    }
+
+    SECTION( "guards in other threads delay deletion" )
+    {
+        std::atomic<bool> entered { false }, done { false };
+        std::thread reader([&]()
+        {
+            Epoch::Guard guard;
+            entered = true;
+            while (!done) std::this_thread::yield();
+        });
+        while (!entered) std::this_thread::yield();
+
+        Epoch::retire(new Counted { deleted });
+        Epoch::collect();
+        CHECK(deleted == 0);
+
+        done = true;
+        reader.join();
+
+        Epoch::collect();
+        CHECK(deleted == 1);
+    }
+}
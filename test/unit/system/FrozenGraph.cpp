@@ -0,0 +1,136 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/FrozenGraph.h"
+
+TEST_CASE( "syn::TypeStore::freeze", "[syn::FrozenGraph]" )
+{
+    test_require_syn_boot();
+
+    auto is_a = syn::type<syn::core::EIsA>::graphNode();
+    auto method = syn::type<syn::core::EUsingDispatcherFunction>::graphNode();
+
+    syn::TypeStore store;
+    auto a = store.addNode<syn::core::NAbstract>({ });
+    auto b = store.addNode<syn::core::NAbstract>({ });
+    auto c = store.addNode<syn::core::NAbstract>({ });
+    auto d = store.addNode<syn::core::NDispatcher>({ });
+    store.addIsA(b, a);
+    store.addIsA(c, b);
+    store.addMethod(d, b);
+    store.addProp<syn::core::PModuleSymbol>({ store.s().require("b") }, b);
+
+    store.freeze();
+    REQUIRE(store.frozen() != nullptr);
+    CHECK(store.frozen()->nodeCount() == store.g().nodeCount());
+
+    SECTION( "serves the edges on a node, by type" )
+    {
+        size_t edges = 0;
+        store.forAllEdgesOnNode(b, [&](auto e) { edges += 1; });
+        CHECK(edges == 3);
+
+        std::vector<syn::Graph::Edge const*> methods;
+        store.forAllEdgesOfTypeOnNode(b, method, [&](auto e) { methods.push_back(e); });
+        REQUIRE(methods.size() == 1);
+        CHECK(methods[0]->nodes[0] == d);
+
+        size_t supers = 0;
+        store.forAllEdgesOfTypeOnNode(c, is_a, [&](auto e) { supers += 1; });
+        CHECK(supers == 1);
+    }
+
+    SECTION( "serves the props on a node" )
+    {
+        size_t props = 0;
+        store.forAllPropsOnNode(b, [&](auto p)
+        {
+            props += 1;
+            CHECK(p->type.node == syn::type<syn::core::PModuleSymbol>::graphNode());
+        });
+        CHECK(props == 1);
+    }
+
+    SECTION( "serves isA" )
+    {
+        CHECK(store.isA(c, a));
+        CHECK(store.isA(b, a));
+        CHECK(store.isA(a, c) == false);
+        CHECK(store.isA(d, a) == false);
+        CHECK(store.frozen()->isA(c, a) == store.subtypes().isA(c, a));
+    }
+
+    SECTION( "serves query plans" )
+    {
+        auto supers = syn::QueryPlan().repeatOut(syn::type<syn::core::EIsA>::id());
+        syn::QueryPlan::Scratch scratch;
+        CHECK(supers.run(store, c, scratch) == 2);
+        CHECK(supers.reaches(store, c, a, scratch));
+    }
+
+    SECTION( "thaws once the store changes" )
+    {
+        auto e = store.addNode<syn::core::NAbstract>({ });
+        store.addIsA(e, c);
+
+        CHECK(store.frozen() == nullptr);
+        CHECK(store.isA(e, a));
+
+        size_t edges = 0;
+        store.forAllEdgesOnNode(c, [&](auto e) { edges += 1; });
+        CHECK(edges == 2);
+
+        store.freeze();
+        CHECK(store.frozen() != nullptr);
+        CHECK(store.isA(e, a));
+    }
+
+    SECTION( "stays frozen under an overlay" )
+    {
+        syn::TypeStore overlay(&store);
+        auto e = overlay.addNode<syn::core::NAbstract>({ });
+        overlay.addIsA(e, c);
+
+        CHECK(store.frozen() != nullptr);
+        CHECK(overlay.isA(e, a));
+        CHECK_THROWS(overlay.freeze());
+    }
+
+    SECTION( "thaw drops the copy" )
+    {
+        store.thaw();
+        CHECK(store.frozen() == nullptr);
+        CHECK(store.isA(c, a));
+    }
+
+    SECTION( "may be refrozen and thawed while read" )
+    {
+        std::atomic<bool> done { false };
+        std::atomic<size_t> wrong { 0 };
+        std::thread reader([&]()
+        {
+            while (!done.load())
+            {
+                if (!store.isA(c, a))
+                    wrong += 1;
+                size_t edges = 0;
+                store.forAllEdgesOnNode(b, [&](auto e) { edges += 1; });
+                if (edges != 3)
+                    wrong += 1;
+            }
+        });
+
+        for (int i = 0; i < 200; ++i)
+        {
+            store.thaw();
+            store.freeze();
+        }
+        done = true;
+        reader.join();
+        syn::Epoch::collect();
+
+        CHECK(wrong == 0);
+    }
+}
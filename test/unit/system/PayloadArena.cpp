@@ -0,0 +1,71 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/PayloadArena.h"
+
+using namespace syn;
+
+namespace
+{
+    struct Tracked
+    {
+        static size_t live;
+
+        uint64_t values[4];
+
+        Tracked(uint64_t v) : values { v, v, v, v } { live += 1; }
+        Tracked(Tracked const& that) : values { that.values[0], that.values[1], that.values[2], that.values[3] } { live += 1; }
+        ~Tracked() { live -= 1; }
+    };
+
+    size_t Tracked::live = 0;
+}
+
+TEST_CASE( "syn::PayloadArena", "[syn::PayloadArena]" )
+{
+    SECTION( "stores values contiguously and destroys them with the arena" )
+    {
+        {
+            PayloadArena arena;
+            std::vector<Tracked*> made;
+            for (uint64_t i = 0; i < 1000; ++i)
+                made.push_back(arena.make(Tracked(i)));
+
+            CHECK(arena.count() == 1000);
+            CHECK(Tracked::live == 1000);
+            CHECK(made[1] == made[0] + 1);
+            CHECK(made[999]->values[3] == 999);
+        }
+
+        CHECK(Tracked::live == 0);
+    }
+
+    SECTION( "is only current inside a scope" )
+    {
+        PayloadArena a, b;
+        CHECK(PayloadArena::current() == nullptr);
+        {
+            PayloadArena::Scope outer(a);
+            CHECK(PayloadArena::current() == &a);
+            {
+                PayloadArena::Scope inner(b);
+                CHECK(PayloadArena::current() == &b);
+            }
+            CHECK(PayloadArena::current() == &a);
+        }
+        CHECK(PayloadArena::current() == nullptr);
+    }
+}
+
+TEST_CASE( "syn::TypeStore::payloads", "[syn::PayloadArena]" )
+{
+    test_require_syn_boot();
+
+    TypeStore store;
+    auto n = store.addNode<core::NValueSpecializer>({ 1, TypeId(), 7 });
+
+    CHECK(store.payloads().count() == 1);
+    CHECK(GraphConfig::typed_load<core::NValueSpecializer>(n->data)->key == 7);
+}
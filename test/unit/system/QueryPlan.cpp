@@ -0,0 +1,129 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/QueryPlan.h"
+
+#include <algorithm>
+
+using Node = syn::Graph::Node;
+
+namespace
+{
+    bool contains(std::vector<Node const*> const& nodes, Node const* node)
+    {
+        return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+    }
+}
+
+TEST_CASE( "syn::QueryPlan", "[syn::QueryPlan]" )
+{
+    test_require_syn_boot();
+
+    auto is_a = syn::type<syn::core::EIsA>::id();
+
+    // d is-a c is-a b is-a a, and e is-a b
+    syn::TypeStore store;
+    auto a = store.addNode<syn::core::NAbstract>({ });
+    auto b = store.addNode<syn::core::NAbstract>({ });
+    auto c = store.addNode<syn::core::NAbstract>({ });
+    auto d = store.addNode<syn::core::NAbstract>({ });
+    auto e = store.addNode<syn::core::NAbstract>({ });
+    store.addIsA(b, a);
+    store.addIsA(c, b);
+    store.addIsA(d, c);
+    store.addIsA(e, b);
+
+    syn::QueryPlan::Scratch scratch;
+
+    SECTION( "out and in follow one edge" )
+    {
+        auto supers = syn::QueryPlan().out(is_a);
+        CHECK(supers.run(store, d, scratch) == 1);
+        CHECK(scratch.results()[0] == c);
+
+        auto subs = syn::QueryPlan().in(is_a);
+        CHECK(subs.run(store, b, scratch) == 2);
+        CHECK(contains(scratch.results(), c));
+        CHECK(contains(scratch.results(), e));
+    }
+
+    SECTION( "steps compose" )
+    {
+        auto siblings = syn::QueryPlan().out(is_a).in(is_a);
+        siblings.run(store, e, scratch);
+        CHECK(scratch.results().size() == 2);
+        CHECK(contains(scratch.results(), c));
+        CHECK(contains(scratch.results(), e));
+    }
+
+    SECTION( "repeats reach the closure, breadth first" )
+    {
+        auto supers = syn::QueryPlan().repeatOut(is_a);
+        CHECK(supers.run(store, d, scratch) == 3);
+        CHECK(scratch.results() == std::vector<Node const*>({ c, b, a }));
+
+        auto subs = syn::QueryPlan().repeatIn(is_a);
+        CHECK(subs.run(store, a, scratch) == 4);
+        CHECK(scratch.results()[0] == b);
+    }
+
+    SECTION( "take and result buffers limit the results" )
+    {
+        auto first = syn::QueryPlan().repeatOut(is_a).take(2);
+        CHECK(first.run(store, d, scratch) == 2);
+
+        Node const* results[1];
+        auto supers = syn::QueryPlan().repeatOut(is_a);
+        CHECK(supers.run(store, d, results, 1, scratch) == 1);
+        CHECK(results[0] == c);
+    }
+
+    SECTION( "reaches" )
+    {
+        auto supers = syn::QueryPlan().repeatOut(is_a);
+        CHECK(supers.reaches(store, d, a, scratch));
+        CHECK(supers.reaches(store, e, c, scratch) == false);
+        CHECK(supers.reaches(store, a, d, scratch) == false);
+    }
+
+    SECTION( "memos recompute once the store changes" )
+    {
+        auto supers = syn::QueryPlan().repeatOut(is_a);
+        syn::QueryPlan::Memo memo(supers);
+
+        CHECK(memo.run(store, e).size() == 2);
+        CHECK(&memo.run(store, e) == &memo.run(store, e));
+
+        store.addIsA(e, d);
+        CHECK(memo.run(store, e).size() == 4);
+    }
+
+    SECTION( "skips retired edges" )
+    {
+        int source;
+        {
+            syn::TypeStore::Source scope(&source);
+            store.addIsA(e, d);
+        }
+
+        auto supers = syn::QueryPlan().repeatOut(is_a);
+        CHECK(supers.reaches(store, e, d, scratch));
+
+        store.retire(&source);
+        CHECK(supers.reaches(store, e, d, scratch) == false);
+    }
+
+    SECTION( "sees an overlay's base" )
+    {
+        syn::TypeStore overlay(&store);
+        auto f = overlay.addNode<syn::core::NAbstract>({ });
+        overlay.addIsA(f, d);
+
+        auto supers = syn::QueryPlan().repeatOut(is_a);
+        CHECK(supers.run(overlay, f, scratch) == 4);
+        CHECK(supers.reaches(overlay, f, a, scratch));
+        CHECK(supers.reaches(store, d, f, scratch) == false);
+    }
+}
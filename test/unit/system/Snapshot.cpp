@@ -0,0 +1,75 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/Snapshot.h"
+
+using namespace syn;
+
+TEST_CASE( "syn::Snapshot", "[syn::Snapshot]" )
+{
+    auto path = (std::filesystem::temp_directory_path() / "syn-test-snapshot.bin").string();
+    std::filesystem::remove(path);
+
+    TypeStore store;
+    auto a = store.s().require("a");
+    auto b = store.s().require("a much longer symbol name");
+
+    SECTION( "missing or invalid images do not open" )
+    {
+        CHECK(Snapshot::open(path) == nullptr);
+
+        std::ofstream(path) << "not a snapshot, but long enough to hold a header";
+        CHECK(Snapshot::open(path) == nullptr);
+    }
+
+    SECTION( "round trips the symbol table" )
+    {
+        Snapshot::write(path, store, 42);
+
+        auto image = Snapshot::open(path);
+        REQUIRE(image != nullptr);
+        CHECK(image->fingerprint() == 42);
+        CHECK(image->symbolCount() == 2);
+
+        TypeStore seeded;
+        image->seed(seeded);
+        image = nullptr;
+
+        CHECK(seeded.s().count() == 2);
+        CHECK(seeded.s().find("a") == a);
+        CHECK(seeded.s().getString(b) == "a much longer symbol name");
+        CHECK((uintptr_t)seeded.s().require("c") == 3);
+
+        CHECK_THROWS(Snapshot::open(path)->seed(seeded));
+    }
+
+    SECTION( "truncated symbols do not seed" )
+    {
+        Snapshot::write(path, store, 42);
+
+        // Only the first symbol's length fits, `symbolsSize` follows five other fields
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            uint64_t symbols_size = sizeof(size_t);
+            file.seekp(8 + 4 + 4 + 8 + 8 + 8);
+            file.write(reinterpret_cast<char const*>(&symbols_size), sizeof(symbols_size));
+        }
+
+        auto image = Snapshot::open(path);
+        REQUIRE(image != nullptr);
+
+        TypeStore seeded;
+        CHECK_THROWS(image->seed(seeded));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE( "syn::CppSystem::fingerprint", "[syn::Snapshot]" )
+{
+    test_require_syn_boot();
+
+    CHECK(syn::system().fingerprint() == syn::system().fingerprint());
+}
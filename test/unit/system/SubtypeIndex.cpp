@@ -0,0 +1,102 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/SubtypeIndex.h"
+
+using namespace syn;
+
+TEST_CASE( "syn::SubtypeIndex", "[syn::SubtypeIndex]" )
+{
+    syn::SubtypeIndex index;
+
+    // The index never dereferences nodes, so any distinct addresses will do
+    Graph::Node const* nodes = reinterpret_cast<Graph::Node const*>(uintptr_t(0x1000));
+    auto top = nodes + 0, left = nodes + 1, right = nodes + 2, bottom = nodes + 3, other = nodes + 4;
+
+    SECTION( "is empty by default" )
+    {
+        CHECK(index.count() == 0);
+        CHECK(!index.isA(bottom, top));
+    }
+
+    SECTION( "direct and transitive edges" )
+    {
+        index.addIsA(left, top);
+        index.addIsA(bottom, left);
+
+        CHECK(index.isA(left, top));
+        CHECK(index.isA(bottom, left));
+        CHECK(index.isA(bottom, top));
+        CHECK(!index.isA(top, bottom));
+        CHECK(!index.isA(bottom, other));
+    }
+
+    SECTION( "multiple inheritance" )
+    {
+        index.addIsA(bottom, left);
+        index.addIsA(bottom, right);
+
+        CHECK(index.isA(bottom, left));
+        CHECK(index.isA(bottom, right));
+        CHECK(!index.isA(left, right));
+    }
+
+    SECTION( "edges added to an ancestor propagate down" )
+    {
+        index.addIsA(bottom, left);
+        index.addIsA(left, top);
+
+        CHECK(index.isA(bottom, top));
+    }
+
+    SECTION( "descendants" )
+    {
+        index.addIsA(left, top);
+        index.addIsA(right, top);
+        index.addIsA(bottom, left);
+        index.addIsA(bottom, right);
+
+        std::vector<Graph::Node const*> found;
+        index.forAllDescendants(top, [&](Graph::Node const* n) { found.push_back(n); });
+        std::sort(found.begin(), found.end());
+
+        CHECK(found == std::vector<Graph::Node const*> { left, right, bottom });
+    }
+
+    SECTION( "removing an edge only loses what no other path keeps" )
+    {
+        index.addIsA(left, top);
+        index.addIsA(right, top);
+        index.addIsA(bottom, left);
+        index.addIsA(bottom, right);
+        index.addIsA(other, left);
+
+        std::set<Graph::Node const*> lost;
+        index.removeIsA(left, top, [&](Graph::Node const* n) { lost.insert(n); });
+
+        CHECK(lost == std::set<Graph::Node const*> { top });
+        CHECK(!index.isA(left, top));
+        CHECK(!index.isA(other, top));
+        CHECK(index.isA(other, left));
+        CHECK(index.isA(bottom, top));
+        CHECK(index.isA(right, top));
+
+        lost.clear();
+        index.removeIsA(bottom, right, [&](Graph::Node const* n) { lost.insert(n); });
+        CHECK(lost == std::set<Graph::Node const*> { right, top });
+        CHECK(!index.isA(bottom, top));
+        CHECK(index.isA(bottom, left));
+    }
+
+    SECTION( "cycles terminate" )
+    {
+        index.addIsA(top, top);
+        index.addIsA(left, top);
+        index.addIsA(top, left);
+
+        CHECK(index.isA(left, top));
+        CHECK(index.isA(top, left));
+    }
+}
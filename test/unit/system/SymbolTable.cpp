@@ -0,0 +1,165 @@
+#include "catch2/catch.hpp"
+
+#include "unit/shared.h"
+
+#include "syn/syn.h"
+#include "syn/system/SymbolTable.h"
+
+using namespace syn;
+
+TEST_CASE( "syn::SymbolTable", "[syn::SymbolTable]" )
+{
+    SymbolTable symbols;
+
+    SECTION( "is empty by default" )
+    {
+        CHECK(symbols.count() == 0);
+        CHECK((uintptr_t)symbols.find("missing") == 0);
+        CHECK_THROWS(symbols.getSymbol("missing"));
+        CHECK_THROWS(symbols.getString(Symbol(1)));
+    }
+
+    SECTION( "ids are dense and sequential" )
+    {
+        CHECK((uintptr_t)symbols.require("a") == 1);
+        CHECK((uintptr_t)symbols.require("b") == 2);
+        CHECK((uintptr_t)symbols.require("a") == 1);
+        CHECK(symbols.count() == 2);
+    }
+
+    SECTION( "heterogeneous lookup" )
+    {
+        std::string owned = "hello";
+        auto sym = symbols.require(owned);
+
+        CHECK(symbols.require("hello") == sym);
+        CHECK(symbols.require(std::string_view("hello world").substr(0, 5)) == sym);
+        CHECK(symbols.getSymbol("hello") == sym);
+    }
+
+    SECTION( "strings are stable" )
+    {
+        auto first = symbols.getString(symbols.require("first"));
+
+        std::vector<Symbol> many;
+        for (size_t i = 0; i < 10000; ++i)
+            many.push_back(symbols.require("symbol/" + std::to_string(i)));
+        symbols.require(std::string(100000, 'x'));
+
+        CHECK(first == "first");
+        CHECK(first.data()[first.size()] == '\0');
+        for (size_t i = 0; i < many.size(); ++i)
+            CHECK(symbols.getString(many[i]) == "symbol/" + std::to_string(i));
+        CHECK(symbols.getString(symbols.require(std::string(100000, 'x'))).size() == 100000);
+    }
+
+    SECTION( "the empty string is a symbol" )
+    {
+        auto sym = symbols.require("");
+
+        CHECK((uintptr_t)sym != 0);
+        CHECK(symbols.getString(sym).empty());
+    }
+
+    SECTION( "concurrent require is dense and consistent" )
+    {
+        std::vector<std::thread> threads;
+        std::atomic<size_t> mismatches { 0 };
+        for (size_t t = 0; t < 8; ++t)
+            threads.emplace_back([&, t]()
+            {
+                for (size_t i = 0; i < 4000; ++i)
+                {
+                    auto str = "symbol/" + std::to_string((i * 7 + t) % 2000);
+                    auto sym = symbols.require(str);
+                    if (symbols.getString(sym) != str || symbols.find(str) != sym)
+                        mismatches += 1;
+                }
+            });
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(mismatches == 0);
+        CHECK(symbols.count() == 2000);
+        for (size_t i = 1; i <= symbols.count(); ++i)
+            CHECK((uintptr_t)symbols.find(symbols.getString(Symbol(i))) == i);
+    }
+
+    SECTION( "literals are hashed at compile time" )
+    {
+        constexpr auto literal = "literal"_sym;
+        static_assert(literal.hash == SymbolTable::hash("literal"), "literal hash");
+
+        auto sym = symbols.require(literal);
+
+        CHECK(symbols.require("literal") == sym);
+        CHECK(symbols.find("literal"_sym) == sym);
+        CHECK((uintptr_t)symbols.find("missing"_sym) == 0);
+    }
+}
+
+TEST_CASE( "SYN_SYMBOL", "[syn::SymbolTable]" )
+{
+    test_require_syn_boot();
+
+    auto sym = SYN_SYMBOL("syn/test/cached");
+
+    CHECK(global_store().s().getString(sym) == "syn/test/cached");
+    for (size_t i = 0; i < 2; ++i)
+        CHECK(SYN_SYMBOL("syn/test/cached") == sym);
+}
+
+TEST_CASE( "syn::SymbolTable::Lookup", "[syn::SymbolTable]" )
+{
+    SymbolTable symbols;
+    SymbolTable::Lookup<int, -1> lookup(symbols);
+
+    auto a = symbols.require("a");
+    auto b = symbols.require("b");
+
+    SECTION( "is empty by default" )
+    {
+        CHECK(lookup.count() == 0);
+        CHECK(lookup.has(a) == false);
+        CHECK(lookup.lookup(a) == -1);
+    }
+
+    SECTION( "set, lookup and erase" )
+    {
+        lookup.set(a, 5);
+        lookup.set(a, 6);
+        lookup.set(b, 0);
+
+        CHECK(lookup.count() == 2);
+        CHECK(lookup.lookup(a) == 6);
+        CHECK(lookup.has(b));
+        CHECK(lookup.lookup(b) == 0);
+
+        lookup.erase(a);
+        lookup.erase(a);
+
+        CHECK(lookup.count() == 1);
+        CHECK(lookup.has(a) == false);
+        CHECK(lookup.lookup(a) == -1);
+    }
+
+    SECTION( "ids past the dense limit" )
+    {
+        Symbol far = SymbolTable::Lookup<int, -1>::DenseLimit + 3;
+        Symbol near = SymbolTable::Lookup<int, -1>::PageSize * 3 + 1;
+
+        lookup.set(far, 1);
+        lookup.set(near, 2);
+
+        CHECK(lookup.count() == 2);
+        CHECK(lookup.lookup(far) == 1);
+        CHECK(lookup.lookup(near) == 2);
+        CHECK(lookup.has(Symbol(far + 1)) == false);
+
+        lookup.clear();
+
+        CHECK(lookup.count() == 0);
+        CHECK(lookup.has(far) == false);
+        CHECK(lookup.has(near) == false);
+    }
+}
@@ -18,8 +18,530 @@ TEST_CASE( "syn::TypeStore (making our own)", "[syn::TypeStore]" )
 
     SECTION( ".s() accesses the symbol table (and it is empty by default)" )
     {
-        auto s = store.s();
+        auto& s = store.s();
 
         CHECK(s.count() == 0);
     }
 }
+
+TEST_CASE( "syn::TypeStore::onlyPropOfTypeOnNode", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore store;
+    auto a = store.addNode<syn::core::NAbstract>({ });
+    auto b = store.addNode<syn::core::NAbstract>({ });
+
+    store.addProp<syn::core::PModuleSymbol>({ store.s().require("a") }, a);
+
+    auto prop = store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(a);
+    REQUIRE(prop != nullptr);
+    CHECK(prop == store.g().onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(a));
+    CHECK(store.s().getString(prop->symbol) == "a");
+
+    CHECK(store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(b) == nullptr);
+    CHECK(store.onlyPropOfTypeOnNode<syn::core::PCppDefine>(a) == nullptr);
+}
+
+TEST_CASE( "syn::TypeStore type indexes", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore store;
+    auto a = store.addNode<syn::core::NAbstract>({ });
+    auto b = store.addNode<syn::core::NAbstract>({ });
+    auto s = store.addNode<syn::core::NStruct>({ });
+    auto is_a = store.addIsA(s, a);
+    store.addProp<syn::core::PModuleSymbol>({ store.s().require("a") }, a);
+    store.addProp<syn::core::PModuleSymbol>({ store.s().require("a2") }, a);
+
+    SECTION( "enumerates only the elements of a type" )
+    {
+        std::vector<syn::Graph::Node const*> abstracts;
+        store.forAllNodesOfType<syn::core::NAbstract>([&](auto n) { abstracts.push_back(n); });
+        CHECK(abstracts == std::vector<syn::Graph::Node const*>({ a, b }));
+
+        std::vector<syn::Graph::Edge const*> edges;
+        store.forAllEdgesOfType<syn::core::EIsA>([&](auto e) { edges.push_back(e); });
+        CHECK(edges == std::vector<syn::Graph::Edge const*>({ is_a }));
+
+        size_t dispatchers = 0;
+        store.forAllNodesOfType<syn::core::NDispatcher>([&](auto n) { dispatchers += 1; });
+        CHECK(dispatchers == 0);
+    }
+
+    SECTION( "enumerates each node with a prop once, with it's newest prop" )
+    {
+        std::vector<syn::Graph::Node const*> nodes;
+        store.forAllNodesWithProp<syn::core::PModuleSymbol>([&](auto n, auto prop)
+        {
+            nodes.push_back(n);
+            CHECK(store.s().getString(prop->symbol) == "a2");
+        });
+        CHECK(nodes == std::vector<syn::Graph::Node const*>({ a }));
+    }
+
+    SECTION( "skips what is retired" )
+    {
+        int source;
+        {
+            syn::TypeStore::Source scope(&source);
+            store.addNode<syn::core::NAbstract>({ });
+            store.addProp<syn::core::PModuleSymbol>({ store.s().require("b") }, b);
+        }
+        store.retire(&source);
+
+        size_t abstracts = 0, symbols = 0;
+        store.forAllNodesOfType<syn::core::NAbstract>([&](auto n) { abstracts += 1; });
+        store.forAllNodesWithProp<syn::core::PModuleSymbol>([&](auto n, auto prop) { symbols += 1; });
+        CHECK(abstracts == 2);
+        CHECK(symbols == 1);
+    }
+
+    SECTION( "an overlay enumerates it's base too" )
+    {
+        syn::TypeStore overlay(&store);
+        auto c = overlay.addNode<syn::core::NAbstract>({ });
+        overlay.addProp<syn::core::PModuleSymbol>({ overlay.s().require("overlay") }, a);
+
+        std::vector<syn::Graph::Node const*> abstracts;
+        overlay.forAllNodesOfType<syn::core::NAbstract>([&](auto n) { abstracts.push_back(n); });
+        CHECK(abstracts == std::vector<syn::Graph::Node const*>({ a, b, c }));
+
+        std::vector<std::string> symbols;
+        overlay.forAllNodesWithProp<syn::core::PModuleSymbol>([&](auto n, auto prop) { symbols.emplace_back(overlay.s().getString(prop->symbol)); });
+        CHECK(symbols == std::vector<std::string>({ "overlay" }));
+    }
+}
+
+TEST_CASE( "syn::TypeStore revisions", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore store;
+    auto a = store.addNode<syn::core::NAbstract>({ });
+    auto b = store.addNode<syn::core::NAbstract>({ });
+
+    auto global = store.globalRevision().load();
+    auto is_a = store.typeRevision<syn::core::EIsA>().load();
+    auto node_a = store.nodeRevision(a).load();
+    auto node_b = store.nodeRevision(b).load();
+
+    SECTION( "adding an edge moves the global, type and node revisions" )
+    {
+        store.addIsA(a, b);
+
+        CHECK(store.globalRevision().load() > global);
+        CHECK(store.revision() == store.globalRevision().load());
+        CHECK(store.typeRevision<syn::core::EIsA>().load() > is_a);
+        CHECK(store.nodeRevision(a).load() > node_a);
+        CHECK(store.nodeRevision(b).load() > node_b);
+    }
+
+    SECTION( "adding a prop moves the node it is on" )
+    {
+        store.addProp<syn::core::PModuleSymbol>({ store.s().require("a") }, a);
+
+        CHECK(store.globalRevision().load() > global);
+        CHECK(store.nodeRevision(a).load() > node_a);
+    }
+
+    SECTION( "dispatch revisions only move with the dispatcher and the subtype closure" )
+    {
+        auto dispatcher = store.addNode<syn::core::NDispatcher>({ });
+        auto function = store.addNode<syn::core::NFunction>({ nullptr });
+
+        // Revisions are striped, keep clear of the dispatcher's stripe
+        auto unrelated = store.addNode<syn::core::NAbstract>({ });
+        while (store.nodeRevision(unrelated).counter == store.nodeRevision(dispatcher).counter)
+            unrelated = store.addNode<syn::core::NAbstract>({ });
+
+        auto revision = store.dispatchRevision(dispatcher);
+        store.addProp<syn::core::PModuleSymbol>({ store.s().require("unrelated") }, unrelated);
+        CHECK(store.dispatchRevision(dispatcher) == revision);
+
+        store.addMethod(dispatcher, function);
+        CHECK(store.dispatchRevision(dispatcher) > revision);
+
+        revision = store.dispatchRevision(dispatcher);
+        store.addIsA(a, b);
+        CHECK(store.dispatchRevision(dispatcher) > revision);
+
+        // Already related, the closure stays the same
+        revision = store.dispatchRevision(dispatcher);
+        auto subtypes = store.subtypeRevision().load();
+        store.addIsA(a, b);
+        CHECK(store.subtypeRevision().load() == subtypes);
+        CHECK(store.dispatchRevision(dispatcher) == revision);
+    }
+}
+
+TEST_CASE( "syn::TypeStore concurrent changes", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore store;
+    auto root = store.addNode<syn::core::NAbstract>({ });
+
+    std::vector<std::vector<syn::Graph::Node*>> added(4);
+    std::vector<std::thread> threads;
+
+    // Reads the store while it grows, every node found must already carry it's prop and edge
+    std::atomic<bool> writing { true };
+    std::atomic<size_t> incomplete { 0 };
+    std::thread reader([&]()
+    {
+        while (writing.load())
+            store.forAllNodesOfType<syn::core::NAbstract>([&](syn::Graph::Node const* n)
+            {
+                if (n == root)
+                    return;
+
+                size_t edges = 0;
+                store.forAllEdgesOnNode(n, [&](auto e) { edges += 1; });
+                if (edges != 0 && (store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(n) == nullptr || !store.isA(n, root)))
+                    incomplete += 1;
+            });
+    });
+
+    for (size_t t = 0; t < added.size(); ++t)
+        threads.emplace_back([&, t]()
+        {
+            for (size_t i = 0; i < 200; ++i)
+            {
+                auto n = store.addNode<syn::core::NAbstract>({ });
+                store.addProp<syn::core::PModuleSymbol>({ store.s().require(std::to_string(t) + "/" + std::to_string(i)) }, n);
+                store.addIsA(n, root);
+                added[t].push_back(n);
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+    writing = false;
+    reader.join();
+
+    CHECK(incomplete == 0);
+
+    for (size_t t = 0; t < added.size(); ++t)
+        for (size_t i = 0; i < added[t].size(); ++i)
+        {
+            auto n = added[t][i];
+            auto prop = store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(n);
+            REQUIRE(prop != nullptr);
+            CHECK(store.s().getString(prop->symbol) == std::to_string(t) + "/" + std::to_string(i));
+            CHECK(store.subtypes().isA(n, root));
+        }
+}
+
+namespace
+{
+    struct DeferredDefinition
+    {
+        syn::TypeStore* store;
+        syn::Graph::Node* node;
+        syn::Graph::Node* super;
+        std::atomic<size_t> runs { 0 };
+
+        static void define(void* context)
+        {
+            auto self = (DeferredDefinition*)context;
+            self->runs += 1;
+
+            // Requiring the node being defined must not recurse
+            self->store->require(self->node);
+            if (self->super != nullptr)
+                self->store->addIsA(self->node, self->super);
+        }
+    };
+}
+
+TEST_CASE( "syn::TypeStore::defer", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore store;
+    auto a = store.addNode<syn::core::NAbstract>({ });
+    auto b = store.addNode<syn::core::NAbstract>({ });
+    auto c = store.addNode<syn::core::NAbstract>({ });
+
+    DeferredDefinition define_a { &store, a, b }, define_b { &store, b, c };
+    store.defer(a, &DeferredDefinition::define, &define_a);
+    store.defer(b, &DeferredDefinition::define, &define_b);
+
+    CHECK(store.deferredCount() == 2);
+    CHECK_THROWS(store.defer(a, &DeferredDefinition::define, &define_a));
+
+    SECTION( "lookups on a node run its definition, and those of its supers" )
+    {
+        CHECK(store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(a) == nullptr);
+
+        CHECK(define_a.runs == 1);
+        CHECK(define_b.runs == 1);
+        CHECK(store.deferredCount() == 0);
+        CHECK(store.subtypes().isA(a, c));
+    }
+
+    SECTION( "definitions run once when required concurrently" )
+    {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < 4; ++i)
+            threads.emplace_back([&]() { store.require(b); });
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(define_a.runs == 0);
+        CHECK(define_b.runs == 1);
+        CHECK(store.deferredCount() == 1);
+
+        store.requireAll();
+
+        CHECK(define_a.runs == 1);
+        CHECK(store.deferredCount() == 0);
+    }
+}
+
+TEST_CASE( "syn::TypeStore::retire", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore store;
+    auto root = store.addNode<syn::core::NAbstract>({ });
+    auto other = store.addNode<syn::core::NAbstract>({ });
+    auto kept = store.addNode<syn::core::NAbstract>({ });
+
+    int first, second;
+    syn::Graph::Node* added;
+    syn::Graph::Edge* is_a;
+    {
+        syn::TypeStore::Source source(&first);
+        added = store.addNode<syn::core::NAbstract>({ });
+        is_a = store.addIsA(kept, root);
+        store.addProp<syn::core::PModuleSymbol>({ store.s().require("first") }, kept);
+    }
+
+    CHECK(syn::TypeStore::Source::current() == nullptr);
+    REQUIRE(store.subtypes().isA(kept, root));
+
+    SECTION( "retires what the source added" )
+    {
+        auto revision = store.revision();
+        store.retire(&first);
+
+        CHECK(store.revision() > revision);
+        CHECK(store.isRetired(added));
+        CHECK(store.isRetired(is_a));
+        CHECK(store.isRetired(kept) == false);
+        CHECK(store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(kept) == nullptr);
+        CHECK(store.subtypes().isA(kept, root) == false);
+    }
+
+    SECTION( "a replacement's props and edges take over" )
+    {
+        {
+            syn::TypeStore::Replacement replacement(store);
+            store.retire(&first);
+
+            syn::TypeStore::Source source(&second);
+            store.addIsA(kept, other);
+            store.addProp<syn::core::PModuleSymbol>({ store.s().require("second") }, kept);
+        }
+
+        auto prop = store.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(kept);
+        REQUIRE(prop != nullptr);
+        CHECK(store.s().getString(prop->symbol) == "second");
+        CHECK(store.subtypes().isA(kept, root) == false);
+        CHECK(store.subtypes().isA(kept, other));
+    }
+
+    SECTION( "a replacement only moves the dispatchers it changes" )
+    {
+        auto changed = store.addNode<syn::core::NDispatcher>({ });
+        auto unchanged = store.addNode<syn::core::NDispatcher>({ });
+        auto replaced = store.addNode<syn::core::NFunction>({ nullptr });
+        auto replacing = store.addNode<syn::core::NFunction>({ nullptr });
+        {
+            syn::TypeStore::Source source(&first);
+            store.addMethod(changed, replaced);
+        }
+
+        // Revisions are striped, keep `unchanged` clear of every node the replacement touches
+        auto touched = [&](syn::Graph::Node const* n) { return store.nodeRevision(n).counter == store.nodeRevision(unchanged).counter; };
+        while (touched(changed) || touched(kept) || touched(root) || touched(added) || touched(replaced) || touched(replacing))
+            unchanged = store.addNode<syn::core::NDispatcher>({ });
+
+        auto revision = store.dispatchRevision(unchanged);
+        auto changed_revision = store.dispatchRevision(changed);
+        {
+            syn::TypeStore::Replacement replacement(store);
+            store.retire(&first);
+
+            syn::TypeStore::Source source(&second);
+            store.addIsA(kept, root);
+            store.addMethod(changed, replacing);
+        }
+
+        CHECK(store.subtypes().isA(kept, root));
+        CHECK(store.dispatchRevision(unchanged) == revision);
+        CHECK(store.dispatchRevision(changed) > changed_revision);
+    }
+
+    SECTION( "retiring an is-a edge only moves the dispatchers on the types it related" )
+    {
+        auto on_root = store.addNode<syn::core::NDispatcher>({ });
+        auto on_other = store.addNode<syn::core::NDispatcher>({ });
+        auto root_method = store.addNode<syn::core::NFunction>({ nullptr });
+        auto other_method = store.addNode<syn::core::NFunction>({ nullptr });
+        store.addProp<syn::core::PDispatchArguments>({ { syn::TypeId(root) } }, root_method);
+        store.addProp<syn::core::PDispatchArguments>({ { syn::TypeId(other) } }, other_method);
+        store.addMethod(on_root, root_method);
+
+        // Revisions are striped, keep `on_other` clear of every node the retirement touches
+        auto touched = [&](syn::Graph::Node const* n) { return store.nodeRevision(n).counter == store.nodeRevision(on_other).counter; };
+        while (touched(on_root) || touched(kept) || touched(root) || touched(added))
+            on_other = store.addNode<syn::core::NDispatcher>({ });
+        store.addMethod(on_other, other_method);
+
+        auto root_revision = store.dispatchRevision(on_root);
+        auto other_revision = store.dispatchRevision(on_other);
+        auto subtypes = store.subtypeRevision().load();
+        store.retire(&first);
+
+        CHECK(store.subtypes().isA(kept, root) == false);
+        CHECK(store.subtypeRevision().load() > subtypes);
+        CHECK(store.dispatchRevision(on_root) > root_revision);
+        CHECK(store.dispatchRevision(on_other) == other_revision);
+    }
+
+    SECTION( "retiring a node retires its edges" )
+    {
+        store.retireNode(root);
+
+        CHECK(store.isRetired(root));
+        CHECK(store.isRetired(is_a));
+        CHECK(store.subtypes().isA(kept, root) == false);
+    }
+
+    SECTION( "retiring drops definitions deferred under the source" )
+    {
+        DeferredDefinition define { &store, other, nullptr };
+        {
+            syn::TypeStore::Source source(&second);
+            store.defer(other, &DeferredDefinition::define, &define);
+        }
+        REQUIRE(store.deferredCount() == 1);
+
+        store.retire(&second);
+
+        CHECK(store.deferredCount() == 0);
+        store.require(other);
+        CHECK(define.runs == 0);
+    }
+}
+
+TEST_CASE( "syn::TypeStore overlays", "[syn::TypeStore]" )
+{
+    test_require_syn_boot();
+
+    syn::TypeStore base;
+    auto a = base.addNode<syn::core::NAbstract>({ });
+    auto b = base.addNode<syn::core::NAbstract>({ });
+    base.addIsA(a, b);
+    base.addProp<syn::core::PModuleSymbol>({ base.s().require("a") }, a);
+
+    auto revision = base.revision();
+
+    syn::TypeStore overlay(&base);
+    auto c = overlay.addNode<syn::core::NAbstract>({ });
+    overlay.addIsA(c, a);
+    overlay.addProp<syn::core::PModuleSymbol>({ overlay.s().require("overlay") }, a);
+
+    SECTION( "sees the base and it's own additions" )
+    {
+        CHECK(&overlay.s() == &base.s());
+        CHECK(overlay.isA(a, b));
+        CHECK(overlay.isA(c, b));
+        CHECK(overlay.isA(b, c) == false);
+
+        auto prop = overlay.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(a);
+        REQUIRE(prop != nullptr);
+        CHECK(overlay.s().getString(prop->symbol) == "overlay");
+
+        size_t edges = 0;
+        overlay.forAllEdgesOnNode(a, [&](auto e) { edges += 1; });
+        CHECK(edges == 2);
+    }
+
+    SECTION( "leaves the base alone" )
+    {
+        CHECK(base.revision() == revision);
+        CHECK(base.isA(c, b) == false);
+
+        auto prop = base.onlyPropOfTypeOnNode<syn::core::PModuleSymbol>(a);
+        REQUIRE(prop != nullptr);
+        CHECK(base.s().getString(prop->symbol) == "a");
+
+        size_t edges = 0;
+        base.forAllEdgesOnNode(a, [&](auto e) { edges += 1; });
+        CHECK(edges == 1);
+    }
+
+    SECTION( "keeps it's bookkeeping apart, with shadows for the base nodes it changed" )
+    {
+        REQUIRE(overlay.overlay() != nullptr);
+        CHECK(base.overlay() == nullptr);
+        CHECK(overlay.base() == &base);
+        CHECK(overlay.overlay()->owns(c));
+        CHECK(overlay.overlay()->owns(a) == false);
+
+        auto shadow = overlay.overlay()->shadowOf(a);
+        REQUIRE(shadow != nullptr);
+        CHECK(overlay.canonical(shadow) == a);
+        CHECK(overlay.overlay()->shadowOf(b) == nullptr);
+    }
+
+    SECTION( "has revisions apart from the base, that only grow" )
+    {
+        CHECK(overlay.revision() > base.revision());
+
+        auto before = overlay.revision();
+        overlay.addNode<syn::core::NAbstract>({ });
+        CHECK(overlay.revision() > before);
+
+        before = overlay.revision();
+        base.addNode<syn::core::NAbstract>({ });
+        CHECK(overlay.revision() > before);
+
+        syn::TypeStore other(&base);
+        CHECK(other.revision() != overlay.revision());
+    }
+
+    SECTION( "relates through both store's edges" )
+    {
+        // e is-a d (overlay) is-a c (overlay) is-a a (base) is-a b (base), with f is-a e in the base
+        auto d = base.addNode<syn::core::NAbstract>({ });
+        auto e = base.addNode<syn::core::NAbstract>({ });
+        auto f = base.addNode<syn::core::NAbstract>({ });
+        base.addIsA(f, e);
+
+        overlay.addIsA(e, d);
+        CHECK(overlay.isA(f, d));
+        CHECK(overlay.isA(f, b) == false);
+
+        overlay.addIsA(d, c);
+        CHECK(overlay.isA(e, c));
+        CHECK(overlay.isA(f, a));
+        CHECK(overlay.isA(f, b));
+        CHECK(overlay.isA(b, f) == false);
+        CHECK(base.isA(f, b) == false);
+    }
+
+    SECTION( "is the thread store while in scope" )
+    {
+        CHECK(syn::TypeStore::Scope::current() == nullptr);
+        {
+            syn::TypeStore::Scope scope(overlay);
+            CHECK(&syn::thread_store() == &overlay);
+        }
+        CHECK(&syn::thread_store() == &syn::global_store());
+    }
+}
@@ -29,5 +29,338 @@ TEST_CASE( "is-a", "[system]" )
         CHECK(syn::is_a(syn::type<uint64_t>::id(), syn::core::Integral));
         
         CHECK(syn::is_a(syn::type<uint64_t>::id(), syn::core::Numeric));
+        CHECK(!syn::is_a(syn::core::Numeric, syn::type<uint64_t>::id()));
+    }
+
+    SECTION( "multiple abstracts" )
+    {
+        CHECK(syn::is_a(syn::type<syn::core::NBits>::id(), syn::core::MetaNode));
+        CHECK(syn::is_a(syn::type<syn::core::NBits>::id(), syn::core::Type));
+        CHECK(syn::is_a(syn::type<syn::core::NBits>::id(), syn::core::Meta));
+    }
+}
+
+TEST_CASE( "basic dispatch", "[system]" )
+{
+    test_require_syn_boot();
+
+    SECTION( "resolves a method by argument type" )
+    {
+        TypeId args[] = { syn::type<syn::core::Vector>::id() };
+        auto method = syn::basic_dispatch(syn::core::count, args, 1);
+
+        CHECK(method != None);
+        CHECK(syn::basic_dispatch(syn::core::count, args, 1) == method);
+
+        TypeId other_args[] = { syn::type<syn::core::Set>::id() };
+        CHECK(syn::basic_dispatch(syn::core::count, other_args, 1) != None);
+        CHECK(syn::basic_dispatch(syn::core::count, other_args, 1) != method);
+    }
+
+    SECTION( "no method" )
+    {
+        TypeId args[] = { syn::type<std::string>::id() };
+        CHECK(syn::basic_dispatch(syn::core::count, args, 1) == None);
+        CHECK(syn::basic_dispatch(syn::core::count, args, 0) == None);
+    }
+
+    SECTION( "wildcard arguments" )
+    {
+        TypeId args[] = { syn::type<std::string>::id(), syn::type<uint64_t>::id() };
+        CHECK(syn::basic_dispatch(syn::core::promote, args, 2) != None);
+    }
+
+    SECTION( "results are cached on the dispatcher" )
+    {
+        TypeId args[] = { syn::type<syn::core::ByteVector>::id() };
+        auto method = syn::basic_dispatch(syn::core::count, args, 1);
+
+        TypeId cached;
+        CHECK(syn::dispatch_cache(syn::core::count).find(syn::thread_store().dispatchRevision(syn::core::count.node), args, 1, cached));
+        CHECK(cached == method);
+    }
+
+    SECTION( "concurrent readers" )
+    {
+        TypeId types[] = {
+            syn::type<syn::core::Vector>::id(),
+            syn::type<syn::core::Set>::id(),
+            syn::type<syn::core::ByteVector>::id(),
+        };
+        TypeId expected[3];
+        for (size_t i = 0; i < 3; ++i)
+            expected[i] = syn::basic_dispatch(syn::core::count, &types[i], 1);
+
+        std::atomic<size_t> wrong { 0 };
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < 4; ++t)
+            readers.emplace_back([&]()
+            {
+                for (size_t i = 0; i < 10000; ++i)
+                    if (syn::basic_dispatch(syn::core::count, &types[i % 3], 1) != expected[i % 3])
+                        wrong += 1;
+            });
+
+        // Flushing forces readers to refill (and writers to retire tables) while they run.
+        auto& cache = syn::dispatch_cache(syn::core::count);
+        for (size_t i = 0; i < 100; ++i)
+            cache.clear(syn::thread_store().dispatchRevision(syn::core::count.node));
+
+        for (auto& reader : readers)
+            reader.join();
+
+        CHECK(wrong == 0);
+    }
+}
+
+TEST_CASE( "syn::DispatchCache", "[system]" )
+{
+    test_require_syn_boot();
+
+    // Only compared, these need not be nodes
+    std::vector<uint64_t> fake(1000);
+    auto id = [&](size_t i) { return TypeId((Graph::Node*)&fake[i]); };
+
+    syn::DispatchCache cache;
+
+    SECTION( "keeps every tuple as it grows" )
+    {
+        for (size_t i = 0; i < fake.size(); ++i)
+        {
+            TypeId args[] = { id(i), id((i * 7) % fake.size()) };
+            cache.insert(1, args, 1 + i % 2, id(i));
+        }
+        CHECK(cache.count() == fake.size());
+
+        size_t wrong = 0;
+        for (size_t i = 0; i < fake.size(); ++i)
+        {
+            TypeId args[] = { id(i), id((i * 7) % fake.size()) };
+            TypeId result;
+            if (!cache.find(1, args, 1 + i % 2, result) || result != id(i))
+                wrong += 1;
+        }
+        CHECK(wrong == 0);
+    }
+
+    SECTION( "is read while filled" )
+    {
+        TypeId first = id(0);
+        cache.insert(1, &first, 1, first);
+
+        std::atomic<bool> done { false };
+        std::atomic<size_t> wrong { 0 };
+        std::thread reader([&]()
+        {
+            while (!done.load())
+            {
+                TypeId result;
+                if (!cache.find(1, &first, 1, result) || result != first)
+                    wrong += 1;
+            }
+        });
+
+        for (size_t i = 1; i < fake.size(); ++i)
+        {
+            TypeId arg = id(i);
+            cache.insert(1, &arg, 1, arg);
+        }
+        done = true;
+        reader.join();
+
+        CHECK(wrong == 0);
+        CHECK(cache.count() == fake.size());
+    }
+
+    SECTION( "starts over for a newer revision" )
+    {
+        TypeId arg = id(0), result;
+        cache.insert(1, &arg, 1, arg);
+        cache.insert(2, &arg, 1, id(1));
+        CHECK(cache.count() == 1);
+        CHECK(cache.find(1, &arg, 1, result) == false);
+        CHECK(cache.find(2, &arg, 1, result));
+        CHECK(result == id(1));
+
+        cache.insert(1, &arg, 1, arg);
+        CHECK(cache.find(2, &arg, 1, result));
+        CHECK(result == id(1));
+    }
+
+    syn::Epoch::collect();
+}
+
+TEST_CASE( "dispatch caches of a store", "[system]" )
+{
+    test_require_syn_boot();
+
+    // Leaks show under ASan, the caches made here must go with each store
+    for (int i = 0; i < 64; ++i)
+    {
+        TypeStore store;
+        auto type = store.addNode<syn::core::NStruct>({ });
+        auto dispatcher = store.addNode<syn::core::NDispatcher>({ });
+        auto function = store.addNode<syn::core::NFunction>({ nullptr });
+        store.addProp<syn::core::PDispatchArguments>({ { TypeId(type) } }, function);
+        store.addMethod(dispatcher, function);
+
+        TypeStore::Scope scope(store);
+        TypeId args[] = { TypeId(type) };
+        CHECK(syn::basic_dispatch(TypeId(dispatcher), args, 1) == TypeId(function));
+        syn::compile_dispatcher(TypeId(dispatcher));
+        CHECK(syn::DispatchCache::on(dispatcher).load() != nullptr);
+    }
+    syn::Epoch::collect();
+}
+
+TEST_CASE( "overlay dispatch", "[system]" )
+{
+    test_require_syn_boot();
+
+    auto& global = syn::global_store();
+    auto revision = global.revision();
+
+    // A type and a `count` method only the overlay knows about
+    TypeStore overlay(&global);
+    auto type = overlay.addNode<syn::core::NStruct>({ });
+    overlay.addIsA(type, syn::core::AbstractVector.node);
+    auto function = overlay.addNode<syn::core::NFunction>({ nullptr });
+    overlay.addProp<syn::core::PDispatchArguments>({ { TypeId(type) } }, function);
+    overlay.addMethod(syn::core::count.node, function);
+
+    TypeId args[] = { TypeId(type) };
+
+    SECTION( "only resolves in the overlay" )
+    {
+        CHECK(syn::basic_dispatch(syn::core::count, args, 1) == None);
+        {
+            TypeStore::Scope scope(overlay);
+            CHECK(syn::is_a(TypeId(type), syn::core::AbstractContainer));
+            CHECK(syn::basic_dispatch(syn::core::count, args, 1) == TypeId(function));
+            CHECK(&syn::dispatch_cache(syn::core::count) == &overlay.overlay()->dispatchCache(syn::core::count.node));
+        }
+        CHECK(syn::basic_dispatch(syn::core::count, args, 1) == None);
+        CHECK(syn::is_a(TypeId(type), syn::core::AbstractContainer) == false);
+    }
+
+    SECTION( "keeps caching as the overlay changes" )
+    {
+        TypeStore::Scope scope(overlay);
+        CHECK(syn::basic_dispatch(syn::core::count, args, 1) == TypeId(function));
+
+        // Moves the overlay's revisions, it's cache must take the newer results
+        auto sub = overlay.addNode<syn::core::NStruct>({ });
+        overlay.addIsA(sub, type);
+        TypeId sub_args[] = { TypeId(sub) };
+        CHECK(syn::basic_dispatch(syn::core::count, sub_args, 1) == TypeId(function));
+
+        TypeId cached;
+        auto& cache = overlay.overlay()->dispatchCache(syn::core::count.node);
+        CHECK(cache.find(overlay.dispatchRevision(syn::core::count.node), sub_args, 1, cached));
+        CHECK(cached == TypeId(function));
+    }
+
+    SECTION( "still resolves the base's methods" )
+    {
+        TypeId vector_args[] = { syn::type<syn::core::Vector>::id() };
+        auto method = syn::basic_dispatch(syn::core::count, vector_args, 1);
+
+        TypeStore::Scope scope(overlay);
+        CHECK(syn::basic_dispatch(syn::core::count, vector_args, 1) == method);
+    }
+
+    CHECK(global.revision() == revision);
+}
+
+TEST_CASE( "value dispatch", "[system]" )
+{
+    test_require_syn_boot();
+
+    TypeId types[] = { syn::type<TypeId>::id(), syn::type<std::string>::id() };
+    TypeId requested = syn::type<uint64_t>::id();
+    std::string text = "42";
+    void const* values[] = { &requested, &text };
+
+    SECTION( "values are only dispatched on when given" )
+    {
+        CHECK(syn::value_dispatched(test_parse, types, 2));
+
+        auto by_type = syn::basic_dispatch(test_parse, types, 2);
+        auto by_value = syn::basic_dispatch(test_parse, types, 2, values);
+
+        CHECK(by_type != None);
+        CHECK(by_value != None);
+        CHECK(by_type != by_value);
+    }
+
+    SECTION( "different values select different methods" )
+    {
+        TypeId other = syn::type<int64_t>::id();
+        void const* other_values[] = { &other, &text };
+
+        CHECK(syn::basic_dispatch(test_parse, types, 2, values) != syn::basic_dispatch(test_parse, types, 2, other_values));
+    }
+
+    SECTION( "unspecialized values fall back to type dispatch" )
+    {
+        TypeId other = syn::type<double>::id();
+        void const* other_values[] = { &other, &text };
+
+        CHECK(syn::basic_dispatch(test_parse, types, 2, other_values) == syn::basic_dispatch(test_parse, types, 2));
+    }
+
+    SECTION( "other types are not value dispatched" )
+    {
+        TypeId count_types[] = { syn::type<syn::core::Vector>::id() };
+        CHECK(!syn::value_dispatched(syn::core::count, count_types, 1));
+    }
+}
+
+TEST_CASE( "syn::ValueDispatch", "[system]" )
+{
+    test_require_syn_boot();
+
+    SECTION( "reads keys of exactly the dispatchable types" )
+    {
+        std::apply([](auto... values)
+        {
+            CHECK(((syn::ValueDispatch::keyFunction(syn::type<decltype(values)>::id()) != nullptr) && ...));
+            CHECK((syn::value_dispatchable<decltype(values)>::value && ...));
+        }, syn::details::value_dispatch_types());
+
+        CHECK(syn::ValueDispatch::keyFunction(syn::type<double>::id()) == nullptr);
+        CHECK(!syn::value_dispatchable<double>::value);
+        CHECK(!syn::value_dispatchable<bool>::value);
+        CHECK(!syn::value_dispatchable<char>::value);
+    }
+
+    SECTION( "picks the most specific method whatever order they came in" )
+    {
+        auto type_id = syn::type<TypeId>::id();
+        auto vector = syn::type<syn::core::Vector>::id();
+        auto set = syn::type<syn::core::Set>::id();
+        auto requested = syn::type<uint64_t>::id();
+
+        // Only compared, these need not be functions
+        uint64_t fake[2];
+        TypeId any_function = TypeId((Graph::Node*)&fake[0]), vector_function = TypeId((Graph::Node*)&fake[1]);
+        syn::ValueDispatch::Method any_method = { any_function, { type_id, None }, { { 0, type_id, syn::value_key(requested) } } };
+        syn::ValueDispatch::Method vector_method = { vector_function, { type_id, vector }, { { 0, type_id, syn::value_key(requested) } } };
+
+        for (auto const& methods : { std::vector { any_method, vector_method }, std::vector { vector_method, any_method } })
+        {
+            syn::ValueDispatch values(0, methods);
+            int dummy = 0;
+            void const* args[] = { &requested, &dummy };
+
+            TypeId vector_types[] = { type_id, vector };
+            CHECK(values.lookup(vector_types, args, 2) == vector_function);
+            TypeId set_types[] = { type_id, set };
+            CHECK(values.lookup(set_types, args, 2) == any_function);
+
+            TypeId other = syn::type<int64_t>::id();
+            void const* other_args[] = { &other, &dummy };
+            CHECK(values.lookup(vector_types, other_args, 2) == None);
+        }
     }
 }